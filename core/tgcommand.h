@@ -162,6 +162,51 @@ const QByteArray mouseWheelDown = mouseEventBegin + "65" + separator;
  */
 const QByteArray mouseMoveEvent = mouseEventBegin + "35" + separator;
 
+// Bracketed paste
+// https://invisible-island.net/xterm/ctlseqs/ctlseqs.html#h2-Bracketed-Paste-Mode
+
+/*!
+ * Enables bracketed paste mode: pasted text is surrounded by
+ * bracketedPasteBegin and bracketedPasteEnd markers.
+ */
+const QByteArray bracketedPasteOn = ansiEscape + "?2004" + on;
+
+/*!
+ * Disables bracketed paste mode.
+ */
+const QByteArray bracketedPasteOff = ansiEscape + "?2004" + off;
+
+/*!
+ * Marks the beginning of pasted text.
+ */
+const QByteArray bracketedPasteBegin = ansiEscape + "200~";
+
+/*!
+ * Marks the end of pasted text.
+ */
+const QByteArray bracketedPasteEnd = ansiEscape + "201~";
+
+// Kitty keyboard protocol
+// https://sw.kovidgoyal.net/kitty/keyboard-protocol/
+
+/*!
+ * Asks the terminal which progressive keyboard enhancements are active.
+ * Terminals supporting the protocol reply with `CSI ? flags u`, others
+ * ignore this query.
+ */
+const QByteArray keyboardProtocolQuery = ansiEscape + "?u";
+
+/*!
+ * Pushes "disambiguate escape codes" keyboard mode: Escape, Alt+key and
+ * Ctrl+key combinations are reported as unambiguous `CSI ... u` sequences.
+ */
+const QByteArray keyboardProtocolPush = ansiEscape + ">1u";
+
+/*!
+ * Restores keyboard mode which was active before keyboardProtocolPush.
+ */
+const QByteArray keyboardProtocolPop = ansiEscape + "<u";
+
 /*!
  * Returns terminal command which will move the cursor to position \a x, \a y.
  *
@@ -0,0 +1,133 @@
+#include "tgevent.h"
+
+Tg::Event::Event()
+{
+}
+
+Tg::Event::Event(const Type type, const QByteArray &sequence,
+                 const Key::Modifiers modifiers)
+    : _type(type), _sequence(sequence), _modifiers(modifiers)
+{
+}
+
+Tg::Event::Type Tg::Event::type() const
+{
+    return _type;
+}
+
+QByteArray Tg::Event::sequence() const
+{
+    return _sequence;
+}
+
+Tg::Key::Modifiers Tg::Event::modifiers() const
+{
+    return _modifiers;
+}
+
+bool Tg::Event::isKeyEvent() const
+{
+    return _type == Type::KeyPress;
+}
+
+bool Tg::Event::isMouseEvent() const
+{
+    return _type == Type::MousePress
+            || _type == Type::MouseRelease
+            || _type == Type::MouseMove;
+}
+
+int Tg::Event::count() const
+{
+    return _count;
+}
+
+qint64 Tg::Event::timestamp() const
+{
+    return _timestamp;
+}
+
+Tg::KeyEvent::KeyEvent(const Key::Code key, const QString &text,
+                       const QByteArray &sequence,
+                       const Key::Modifiers modifiers)
+    : Event(Type::KeyPress, sequence, modifiers)
+{
+    _key = key;
+    _text = text;
+}
+
+Tg::KeyEvent::KeyEvent(const Event &event) : Event(event)
+{
+}
+
+Tg::Key::Code Tg::KeyEvent::key() const
+{
+    return _key;
+}
+
+QString Tg::KeyEvent::text() const
+{
+    return _text;
+}
+
+Tg::MouseEvent::MouseEvent(const Type type, const QPoint &position,
+                           const MouseButton button,
+                           const QByteArray &sequence,
+                           const Key::Modifiers modifiers)
+    : Event(type, sequence, modifiers)
+{
+    _position = position;
+    _button = button;
+}
+
+Tg::MouseEvent::MouseEvent(const Event &event) : Event(event)
+{
+}
+
+QPoint Tg::MouseEvent::position() const
+{
+    return _position;
+}
+
+Tg::MouseButton Tg::MouseEvent::button() const
+{
+    return _button;
+}
+
+Tg::WheelEvent::WheelEvent(const QPoint &position, const int delta,
+                           const QByteArray &sequence,
+                           const Key::Modifiers modifiers)
+    : Event(Type::Wheel, sequence, modifiers)
+{
+    _position = position;
+    _delta = delta;
+}
+
+Tg::WheelEvent::WheelEvent(const Event &event) : Event(event)
+{
+}
+
+QPoint Tg::WheelEvent::position() const
+{
+    return _position;
+}
+
+int Tg::WheelEvent::delta() const
+{
+    return _delta;
+}
+
+Tg::PasteEvent::PasteEvent(const QString &text, const QByteArray &sequence)
+    : Event(Type::Paste, sequence, Key::Modifier::NoModifier)
+{
+    _text = text;
+}
+
+Tg::PasteEvent::PasteEvent(const Event &event) : Event(event)
+{
+}
+
+QString Tg::PasteEvent::text() const
+{
+    return _text;
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "tgkey.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QPoint>
+#include <QVector>
+
+namespace Tg {
+/*!
+ * Mouse buttons, as reported by MouseEvent::button().
+ */
+enum class MouseButton {
+    NoButton,
+    Left,
+    Middle,
+    Right
+};
+
+/*!
+ * \brief Single, decoded input event.
+ *
+ * Events are produced by InputParser from raw keyboard buffer and delivered by
+ * Screen to widgets (see Widget::keyPressEvent(), Widget::mousePressEvent(),
+ * Widget::wheelEvent() and Widget::pasteEvent()).
+ *
+ * Event is a small value type. All data is held by this base class, so that
+ * events of different types can be stored together in an EventList. Use
+ * KeyEvent, MouseEvent, WheelEvent or PasteEvent to access type-specific data.
+ */
+class Event
+{
+public:
+    /*!
+     * Type of an Event.
+     */
+    enum class Type {
+        None,
+        KeyPress,
+        MousePress,
+        MouseRelease,
+        MouseMove,
+        Wheel,
+        Paste,
+        //! Terminal confirmed it supports kitty keyboard protocol
+        KeyboardProtocolReply
+    };
+
+    /*!
+     * Constructs an invalid Event of Type::None.
+     */
+    Event();
+
+    /*!
+     * Returns type of this Event.
+     */
+    Type type() const;
+
+    /*!
+     * Returns raw bytes (as read from the terminal) which were decoded into
+     * this Event.
+     */
+    QByteArray sequence() const;
+
+    /*!
+     * Returns keyboard modifiers active when this Event was generated.
+     */
+    Key::Modifiers modifiers() const;
+
+    /*!
+     * Returns `true` if this is a KeyEvent.
+     */
+    bool isKeyEvent() const;
+
+    /*!
+     * Returns `true` if this is a MouseEvent (press, release or move).
+     */
+    bool isMouseEvent() const;
+
+    /*!
+     * Returns the number of identical inputs which were merged into this
+     * Event. Usually 1 (one).
+     *
+     * When a key is held down (or mouse is moved quickly), terminal sends a
+     * burst of identical inputs, which are merged together by
+     * InputParser::compressEvents(). Widgets handling navigation keys should
+     * perform count() steps at once, instead of a single one.
+     */
+    int count() const;
+
+    /*!
+     * Returns the time at which this Event was decoded, in milliseconds since
+     * an unspecified monotonic reference point (see
+     * QElapsedTimer::msecsSinceReference()).
+     *
+     * Compare it with current time to measure input latency.
+     */
+    qint64 timestamp() const;
+
+protected:
+    friend class InputParser;
+
+    Event(const Type type, const QByteArray &sequence,
+          const Key::Modifiers modifiers);
+
+    Type _type = Type::None;
+    QByteArray _sequence;
+    Key::Modifiers _modifiers = Key::Modifier::NoModifier;
+    int _count = 1;
+    qint64 _timestamp = 0;
+
+    // KeyEvent and PasteEvent
+    Key::Code _key = Key::Code::Unknown;
+    QString _text;
+
+    // MouseEvent and WheelEvent
+    QPoint _position;
+    MouseButton _button = MouseButton::NoButton;
+    int _delta = 0;
+};
+
+/*!
+ * Convenient alias for a list of Events.
+ */
+using EventList = QVector<Event>;
+
+/*!
+ * \brief A key press.
+ */
+class KeyEvent : public Event
+{
+public:
+    /*!
+     * Constructs a KeyEvent for \a key, which was decoded from \a sequence.
+     * For printable keys, \a text holds the character(s) which should be
+     * inserted into text fields.
+     */
+    KeyEvent(const Key::Code key, const QString &text,
+             const QByteArray &sequence,
+             const Key::Modifiers modifiers = Key::Modifier::NoModifier);
+
+    /*!
+     * Constructs a KeyEvent from generic \a event.
+     *
+     * \warning \a event has to be of Type::KeyPress.
+     */
+    explicit KeyEvent(const Event &event);
+
+    /*!
+     * Returns decoded key code.
+     */
+    Key::Code key() const;
+
+    /*!
+     * Returns printable text produced by this key press. Empty for keys which
+     * do not produce any text (arrows, function keys, etc.).
+     */
+    QString text() const;
+};
+
+/*!
+ * \brief A mouse button press, release or mouse move.
+ */
+class MouseEvent : public Event
+{
+public:
+    /*!
+     * Constructs a MouseEvent of given \a type, at \a position (in Screen
+     * coordinates), caused by \a button and decoded from \a sequence.
+     */
+    MouseEvent(const Type type, const QPoint &position,
+               const MouseButton button, const QByteArray &sequence,
+               const Key::Modifiers modifiers = Key::Modifier::NoModifier);
+
+    /*!
+     * Constructs a MouseEvent from generic \a event.
+     *
+     * \warning \a event has to be a mouse event (see isMouseEvent()).
+     */
+    explicit MouseEvent(const Event &event);
+
+    /*!
+     * Returns position of the mouse cursor, in Screen coordinates.
+     */
+    QPoint position() const;
+
+    /*!
+     * Returns the button which caused the event. For move events, it is the
+     * button held down during the move (if any).
+     */
+    MouseButton button() const;
+};
+
+/*!
+ * \brief A mouse wheel scroll.
+ */
+class WheelEvent : public Event
+{
+public:
+    /*!
+     * Constructs a WheelEvent at \a position (in Screen coordinates).
+     * Positive \a delta means wheel was scrolled up (away from the user),
+     * negative means down. One step of the wheel equals to 1 (one).
+     */
+    WheelEvent(const QPoint &position, const int delta,
+               const QByteArray &sequence,
+               const Key::Modifiers modifiers = Key::Modifier::NoModifier);
+
+    /*!
+     * Constructs a WheelEvent from generic \a event.
+     *
+     * \warning \a event has to be of Type::Wheel.
+     */
+    explicit WheelEvent(const Event &event);
+
+    /*!
+     * Returns position of the mouse cursor, in Screen coordinates.
+     */
+    QPoint position() const;
+
+    /*!
+     * Returns number of wheel steps. Positive values mean scrolling up.
+     */
+    int delta() const;
+};
+
+/*!
+ * \brief A block of text pasted into the terminal.
+ *
+ * Delivered when terminal supports bracketed paste mode (see
+ * Terminal::enableBracketedPaste()). The whole paste arrives as a single
+ * event, instead of a separate KeyEvent for each character.
+ */
+class PasteEvent : public Event
+{
+public:
+    /*!
+     * Constructs a PasteEvent holding pasted \a text, decoded from
+     * \a sequence (which includes paste begin and end markers).
+     */
+    PasteEvent(const QString &text, const QByteArray &sequence);
+
+    /*!
+     * Constructs a PasteEvent from generic \a event.
+     *
+     * \warning \a event has to be of Type::Paste.
+     */
+    explicit PasteEvent(const Event &event);
+
+    /*!
+     * Returns pasted text. Line breaks are normalized to `\n`.
+     */
+    QString text() const;
+};
+}
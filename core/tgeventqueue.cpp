@@ -0,0 +1,56 @@
+#include "tgeventqueue.h"
+
+Tg::EventQueue::EventQueue(const int capacity)
+    : _events(roundUpToPowerOf2(capacity)),
+      _mask(size_t(_events.size()) - 1)
+{
+}
+
+bool Tg::EventQueue::push(const Event &event)
+{
+    // _head is only written by producer, so relaxed load is enough here
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if ((head - _tail.load(std::memory_order_acquire)) > _mask) {
+        return false;
+    }
+
+    _events[int(head & _mask)] = event;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool Tg::EventQueue::pop(Event *event)
+{
+    // _tail is only written by consumer, so relaxed load is enough here
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    Event &slot = _events[int(tail & _mask)];
+    *event = slot;
+    // Release the data now, instead of when the slot is reused
+    slot = Event();
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool Tg::EventQueue::isEmpty() const
+{
+    return _tail.load(std::memory_order_acquire)
+            == _head.load(std::memory_order_acquire);
+}
+
+int Tg::EventQueue::capacity() const
+{
+    return _events.size();
+}
+
+int Tg::EventQueue::roundUpToPowerOf2(const int value)
+{
+    int result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "tgevent.h"
+
+#include <QVector>
+
+#include <atomic>
+
+namespace Tg {
+/*!
+ * \brief Lock-free, fixed-size queue of Events.
+ *
+ * EventQueue is a ring buffer which can be safely used by exactly two threads
+ * at the same time: one producer (calling push()) and one consumer (calling
+ * pop()). No locks are taken, so a busy consumer never blocks the producer,
+ * and vice versa.
+ *
+ * It is used by InputReader to pass decoded input from the reader thread to
+ * the GUI thread.
+ */
+class EventQueue
+{
+public:
+    /*!
+     * Constructs an EventQueue able to hold \a capacity events. \a capacity is
+     * rounded up to the nearest power of 2.
+     */
+    explicit EventQueue(const int capacity = defaultCapacity);
+
+    /*!
+     * Appends \a event to the queue. Returns `false` if the queue is full.
+     *
+     * \warning Call only from producer thread.
+     */
+    bool push(const Event &event);
+
+    /*!
+     * Removes the oldest Event from the queue and copies it to \a event.
+     * Returns `false` if the queue is empty.
+     *
+     * \warning Call only from consumer thread.
+     */
+    bool pop(Event *event);
+
+    /*!
+     * Returns `true` if there are no events in the queue. The result might
+     * already be outdated when it is returned, if the other thread is active.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * Returns maximum number of events this queue can hold.
+     */
+    int capacity() const;
+
+    static const int defaultCapacity = 1024;
+
+private:
+    static int roundUpToPowerOf2(const int value);
+
+    QVector<Event> _events;
+    const size_t _mask;
+    std::atomic<size_t> _head = { 0 };
+    std::atomic<size_t> _tail = { 0 };
+};
+}
@@ -0,0 +1,639 @@
+#include "tginputparser.h"
+#include "tgcommand.h"
+
+#include <QList>
+
+#include <algorithm>
+
+namespace {
+const char escapeByte = 0x1b;
+
+QString pastedText(const char *data, const int size)
+{
+    QString text = QString::fromUtf8(data, size);
+    text.replace(QStringLiteral("\r\n"), QStringLiteral("\n"));
+    text.replace(QLatin1Char('\r'), QLatin1Char('\n'));
+    return text;
+}
+}
+
+Tg::EventList Tg::InputParser::parse(const QByteArray &bytes)
+{
+    // Timeouts are measured from the arrival of leftover bytes, so they only
+    // apply to sequences which started before this chunk
+    const int leftoverSize = int(_buffer.size());
+    _buffer.append(bytes);
+
+    const bool timedOut = _pendingTimer.isValid()
+            && _pendingTimer.hasExpired(_escapeTimeout);
+    const bool pasteTimedOut = _pendingTimer.isValid()
+            && _pendingTimer.hasExpired(pasteTimeout);
+
+    EventList result;
+    int index = 0;
+    while (index < _buffer.size()) {
+        int consumed = parseEvent(index, &result);
+        if (consumed <= 0) {
+            const int beginSize = int(Command::bracketedPasteBegin.size());
+            const bool isPaste = _buffer.mid(index, beginSize)
+                    == Command::bracketedPasteBegin;
+
+            const bool isLeftover = index < leftoverSize;
+
+            if (isPaste && pasteTimedOut && isLeftover) {
+                // End marker of the paste got lost: deliver what was pasted
+                // so far, instead of swallowing all further input
+                const int begin = index + beginSize;
+                result.append(PasteEvent(
+                                  pastedText(_buffer.constData() + begin,
+                                             _buffer.size() - begin),
+                                  _buffer.mid(index)));
+                _scannedPasteLength = 0;
+                consumed = _buffer.size() - index;
+            } else if (timedOut && isLeftover && isPaste == false
+                       && _buffer.at(index) == escapeByte) {
+                // Nothing more arrived within escapeTimeout(): the ESC byte
+                // is an Escape key press, not a beginning of a sequence
+                result.append(KeyEvent(Key::Code::Escape, QString(),
+                                       _buffer.mid(index, 1)));
+                consumed = 1;
+            } else {
+                // Incomplete sequence, wait for more data
+                break;
+            }
+        }
+
+        index += consumed;
+    }
+
+    _buffer.remove(0, index);
+
+    const qint64 timestamp = QElapsedTimer::msecsSinceReference();
+    for (Event &event : result) {
+        event._timestamp = timestamp;
+    }
+
+    if (_buffer.isEmpty()) {
+        _pendingTimer.invalidate();
+    } else if (bytes.isEmpty() == false || _pendingTimer.isValid() == false) {
+        _pendingTimer.start();
+    }
+
+    return result;
+}
+
+bool Tg::InputParser::hasPendingInput() const
+{
+    return _buffer.isEmpty() == false;
+}
+
+void Tg::InputParser::clear()
+{
+    _buffer.clear();
+    _pendingTimer.invalidate();
+    _scannedPasteLength = 0;
+}
+
+QByteArray Tg::InputParser::takePendingInput()
+{
+    const QByteArray result = _buffer;
+    clear();
+    return result;
+}
+
+int Tg::InputParser::escapeTimeout() const
+{
+    return _escapeTimeout;
+}
+
+void Tg::InputParser::setEscapeTimeout(const int milliseconds)
+{
+    _escapeTimeout = std::max(0, milliseconds);
+}
+
+Tg::EventList Tg::InputParser::compressEvents(const EventList &events)
+{
+    EventList result;
+    result.reserve(events.size());
+
+    for (const Event &event : events) {
+        if (result.isEmpty() || canMerge(result.last(), event) == false) {
+            result.append(event);
+            continue;
+        }
+
+        Event &previous = result.last();
+        previous._sequence.append(event._sequence);
+        previous._count += event._count;
+
+        if (event._type == Event::Type::MouseMove) {
+            previous._position = event._position;
+        } else if (event._type == Event::Type::Wheel) {
+            previous._delta += event._delta;
+        }
+    }
+
+    return result;
+}
+
+int Tg::InputParser::parseEvent(const int index, EventList *events) const
+{
+    if (_buffer.at(index) == escapeByte) {
+        return parseEscape(index, events);
+    }
+
+    return parseCharacter(index, events, Key::Modifier::NoModifier, 0);
+}
+
+int Tg::InputParser::parseEscape(const int index, EventList *events) const
+{
+    if ((index + 1) >= _buffer.size()) {
+        if (_escapeTimeout > 0) {
+            // Could be a beginning of a sequence, wait for escapeTimeout()
+            return 0;
+        }
+
+        events->append(KeyEvent(Key::Code::Escape, QString(),
+                                _buffer.mid(index, 1)));
+        return 1;
+    }
+
+    const char next = _buffer.at(index + 1);
+    if (next == '[') {
+        return parseCsi(index, events);
+    }
+
+    if (next == 'O') {
+        return parseSs3(index, events);
+    }
+
+    if (next == escapeByte) {
+        events->append(KeyEvent(Key::Code::Escape, QString(),
+                                _buffer.mid(index, 1)));
+        return 1;
+    }
+
+    // Escape followed by a regular key means Alt+key
+    return parseCharacter(index, events, Key::Modifier::Alt, 1);
+}
+
+int Tg::InputParser::parseCsi(const int index, EventList *events) const
+{
+    // CSI sequence: ESC [ parameters intermediates final
+    const int begin = index + 2;
+    int end = begin;
+    while (end < _buffer.size()) {
+        const uchar byte = uchar(_buffer.at(end));
+        if (byte >= 0x40 && byte <= 0x7e) {
+            break;
+        }
+
+        if (byte < 0x20 || byte > 0x3f) {
+            // Not a valid CSI sequence, report what we have got so far
+            events->append(KeyEvent(Key::Code::Unknown, QString(),
+                                    _buffer.mid(index, end - index)));
+            return end - index;
+        }
+
+        ++end;
+    }
+
+    if (end >= _buffer.size()) {
+        if ((end - index) > maximumSequenceLength) {
+            events->append(KeyEvent(Key::Code::Unknown, QString(),
+                                    _buffer.mid(index, end - index)));
+            return end - index;
+        }
+
+        return 0;
+    }
+
+    const QByteArray parameters = _buffer.mid(begin, end - begin);
+    const char finalByte = _buffer.at(end);
+    const QByteArray sequence = _buffer.mid(index, end - index + 1);
+
+    if (parameters.startsWith('<') && (finalByte == 'M' || finalByte == 'm')) {
+        appendMouseEvent(parameters.mid(1), finalByte, sequence, events);
+        return sequence.size();
+    }
+
+    if (sequence == Command::bracketedPasteBegin) {
+        return parsePaste(index, end + 1, events);
+    }
+
+    if (parameters.startsWith('?') && finalByte == 'u') {
+        // Reply to Command::keyboardProtocolQuery
+        events->append(Event(Event::Type::KeyboardProtocolReply, sequence,
+                             Key::Modifier::NoModifier));
+        return sequence.size();
+    }
+
+    const QList<QByteArray> parts = parameters.split(';');
+    if (finalByte == 'u') {
+        appendKeyboardProtocolKey(parts, sequence, events);
+        return sequence.size();
+    }
+
+    const int number = parts.value(0).toInt();
+    const Key::Modifiers modifiers = modifiersFromParameter(
+                parts.value(1).toInt());
+
+    Key::Code code = Key::Code::Unknown;
+    switch (finalByte) {
+    case 'A':
+        code = Key::Code::Up;
+        break;
+    case 'B':
+        code = Key::Code::Down;
+        break;
+    case 'C':
+        code = Key::Code::Right;
+        break;
+    case 'D':
+        code = Key::Code::Left;
+        break;
+    case 'H':
+        code = Key::Code::Home;
+        break;
+    case 'F':
+        code = Key::Code::End;
+        break;
+    case 'P':
+        code = Key::Code::F1;
+        break;
+    case 'Q':
+        code = Key::Code::F2;
+        break;
+    case 'R':
+        code = Key::Code::F3;
+        break;
+    case 'S':
+        code = Key::Code::F4;
+        break;
+    case 'Z':
+        code = Key::Code::Backtab;
+        break;
+    case '~':
+        switch (number) {
+        case 1:
+        case 7:
+            code = Key::Code::Home;
+            break;
+        case 2:
+            code = Key::Code::Insert;
+            break;
+        case 3:
+            code = Key::Code::Delete;
+            break;
+        case 4:
+        case 8:
+            code = Key::Code::End;
+            break;
+        case 5:
+            code = Key::Code::PageUp;
+            break;
+        case 6:
+            code = Key::Code::PageDown;
+            break;
+        case 11:
+            code = Key::Code::F1;
+            break;
+        case 12:
+            code = Key::Code::F2;
+            break;
+        case 13:
+            code = Key::Code::F3;
+            break;
+        case 14:
+            code = Key::Code::F4;
+            break;
+        case 15:
+            code = Key::Code::F5;
+            break;
+        case 17:
+            code = Key::Code::F6;
+            break;
+        case 18:
+            code = Key::Code::F7;
+            break;
+        case 19:
+            code = Key::Code::F8;
+            break;
+        case 20:
+            code = Key::Code::F9;
+            break;
+        case 21:
+            code = Key::Code::F10;
+            break;
+        case 23:
+            code = Key::Code::F11;
+            break;
+        case 24:
+            code = Key::Code::F12;
+            break;
+        }
+        break;
+    }
+
+    events->append(KeyEvent(code, QString(), sequence, modifiers));
+    return sequence.size();
+}
+
+int Tg::InputParser::parsePaste(const int index, const int begin,
+                                EventList *events) const
+{
+    // Pasted text is not interpreted at all: it is copied verbatim up to the
+    // end marker, even if it contains escape sequences.
+    //
+    // A long paste arrives in many chunks: only data which was not searched
+    // yet is searched (end marker itself can be split between chunks)
+    const int markerSize = int(Command::bracketedPasteEnd.size());
+    const int from = std::max(begin, begin + _scannedPasteLength - markerSize + 1);
+    const int end = _buffer.indexOf(Command::bracketedPasteEnd, from);
+    if (end < 0) {
+        _scannedPasteLength = _buffer.size() - begin;
+        return 0;
+    }
+
+    _scannedPasteLength = 0;
+
+    const int length = end + markerSize - index;
+    events->append(PasteEvent(pastedText(_buffer.constData() + begin,
+                                         end - begin),
+                              _buffer.mid(index, length)));
+    return length;
+}
+
+int Tg::InputParser::parseSs3(const int index, EventList *events) const
+{
+    // SS3 sequence: ESC O final
+    if ((index + 2) >= _buffer.size()) {
+        return 0;
+    }
+
+    Key::Code code = Key::Code::Unknown;
+    switch (_buffer.at(index + 2)) {
+    case 'A':
+        code = Key::Code::Up;
+        break;
+    case 'B':
+        code = Key::Code::Down;
+        break;
+    case 'C':
+        code = Key::Code::Right;
+        break;
+    case 'D':
+        code = Key::Code::Left;
+        break;
+    case 'H':
+        code = Key::Code::Home;
+        break;
+    case 'F':
+        code = Key::Code::End;
+        break;
+    case 'P':
+        code = Key::Code::F1;
+        break;
+    case 'Q':
+        code = Key::Code::F2;
+        break;
+    case 'R':
+        code = Key::Code::F3;
+        break;
+    case 'S':
+        code = Key::Code::F4;
+        break;
+    }
+
+    events->append(KeyEvent(code, QString(), _buffer.mid(index, 3)));
+    return 3;
+}
+
+int Tg::InputParser::parseCharacter(const int index, EventList *events,
+                                    const Key::Modifiers modifiers,
+                                    const int prefixLength) const
+{
+    const int start = index + prefixLength;
+    const uchar byte = uchar(_buffer.at(start));
+
+    Key::Code code = Key::Code::Character;
+    Key::Modifiers keyModifiers = modifiers;
+    QString text;
+    int length = 1;
+
+    if (byte == '\t') {
+        code = Key::Code::Tab;
+    } else if (byte == '\n' || byte == '\r') {
+        code = Key::Code::Enter;
+    } else if (byte == 0x7f || byte == 0x08) {
+        code = Key::Code::Backspace;
+    } else if (byte == ' ') {
+        code = Key::Code::Space;
+        text = QStringLiteral(" ");
+    } else if (byte == 0x00) {
+        code = Key::Code::Space;
+        text = QStringLiteral(" ");
+        keyModifiers |= Key::Modifier::Ctrl;
+    } else if (byte < 0x1b) {
+        // Ctrl+A ... Ctrl+Z
+        text = QChar(char16_t('a' + byte - 1));
+        keyModifiers |= Key::Modifier::Ctrl;
+    } else if (byte < 0x20) {
+        code = Key::Code::Unknown;
+        keyModifiers |= Key::Modifier::Ctrl;
+    } else if (byte < 0x80) {
+        text = QChar(char16_t(byte));
+    } else {
+        if ((byte & 0xe0) == 0xc0) {
+            length = 2;
+        } else if ((byte & 0xf0) == 0xe0) {
+            length = 3;
+        } else if ((byte & 0xf8) == 0xf0) {
+            length = 4;
+        }
+
+        if ((start + length) > _buffer.size()) {
+            return 0;
+        }
+
+        text = QString::fromUtf8(_buffer.constData() + start, length);
+    }
+
+    const int total = prefixLength + length;
+    events->append(KeyEvent(code, text, _buffer.mid(index, total),
+                            keyModifiers));
+    return total;
+}
+
+void Tg::InputParser::appendKeyboardProtocolKey(const QList<QByteArray> &parts,
+                                                const QByteArray &sequence,
+                                                EventList *events) const
+{
+    // Kitty keyboard protocol: CSI unicode-key-code:alternates ; modifiers u
+    const uint codePoint = parts.value(0).split(':').value(0).toUInt();
+    const Key::Modifiers modifiers = modifiersFromParameter(
+                parts.value(1).split(':').value(0).toInt());
+
+    Key::Code code = Key::Code::Character;
+    QString text;
+    switch (codePoint) {
+    case 9:
+        code = Key::Code::Tab;
+        break;
+    case 13:
+        code = Key::Code::Enter;
+        break;
+    case 27:
+        code = Key::Code::Escape;
+        break;
+    case 32:
+        code = Key::Code::Space;
+        text = QStringLiteral(" ");
+        break;
+    case 127:
+        code = Key::Code::Backspace;
+        break;
+    default:
+        // Code points from Unicode Private Use Area denote functional keys
+        // (keypad, media keys etc.) which are not supported
+        if (codePoint < 32 || (codePoint >= 57344 && codePoint <= 63743)) {
+            code = Key::Code::Unknown;
+        } else if (QChar::requiresSurrogates(codePoint)) {
+            text.append(QChar(QChar::highSurrogate(codePoint)));
+            text.append(QChar(QChar::lowSurrogate(codePoint)));
+        } else {
+            text = QChar(codePoint);
+        }
+        break;
+    }
+
+    if (code == Key::Code::Tab && modifiers.testFlag(Key::Modifier::Shift)) {
+        code = Key::Code::Backtab;
+    }
+
+    events->append(KeyEvent(code, text, sequence, modifiers));
+}
+
+void Tg::InputParser::appendMouseEvent(const QByteArray &parameters,
+                                       const char finalByte,
+                                       const QByteArray &sequence,
+                                       EventList *events) const
+{
+    // SGR mouse encoding: button;x;y followed by M (press) or m (release)
+    const QList<QByteArray> parts = parameters.split(';');
+    if (parts.size() < 3) {
+        events->append(KeyEvent(Key::Code::Unknown, QString(), sequence));
+        return;
+    }
+
+    const int code = parts.at(0).toInt();
+    const QPoint position(parts.at(1).toInt(), parts.at(2).toInt());
+
+    Key::Modifiers modifiers;
+    if (code & 4) {
+        modifiers |= Key::Modifier::Shift;
+    }
+
+    if (code & 8) {
+        modifiers |= Key::Modifier::Alt;
+    }
+
+    if (code & 16) {
+        modifiers |= Key::Modifier::Ctrl;
+    }
+
+    const int buttonCode = code & 0x03;
+
+    if (code & 64) {
+        // Horizontal scrolling (buttons 6 and 7) is not supported
+        if (buttonCode == 0) {
+            events->append(WheelEvent(position, 1, sequence, modifiers));
+        } else if (buttonCode == 1) {
+            events->append(WheelEvent(position, -1, sequence, modifiers));
+        }
+        return;
+    }
+
+    MouseButton button = MouseButton::NoButton;
+    switch (buttonCode) {
+    case 0:
+        button = MouseButton::Left;
+        break;
+    case 1:
+        button = MouseButton::Middle;
+        break;
+    case 2:
+        button = MouseButton::Right;
+        break;
+    }
+
+    Event::Type type = Event::Type::MouseRelease;
+    if (code & 32) {
+        type = Event::Type::MouseMove;
+    } else if (finalByte == 'M') {
+        type = Event::Type::MousePress;
+    }
+
+    events->append(MouseEvent(type, position, button, sequence, modifiers));
+}
+
+Tg::Key::Modifiers Tg::InputParser::modifiersFromParameter(const int parameter)
+{
+    // xterm encodes modifiers as 1 + bitmask
+    Key::Modifiers result;
+    if (parameter <= 1) {
+        return result;
+    }
+
+    const int bits = parameter - 1;
+    if (bits & 0x01) {
+        result |= Key::Modifier::Shift;
+    }
+
+    if (bits & 0x02) {
+        result |= Key::Modifier::Alt;
+    }
+
+    if (bits & 0x04) {
+        result |= Key::Modifier::Ctrl;
+    }
+
+    if (bits & 0x08) {
+        result |= Key::Modifier::Meta;
+    }
+
+    return result;
+}
+
+bool Tg::InputParser::canMerge(const Event &previous, const Event &next)
+{
+    if (previous._type != next._type || previous._modifiers != next._modifiers) {
+        return false;
+    }
+
+    switch (next._type) {
+    case Event::Type::MouseMove:
+        return previous._button == next._button;
+    case Event::Type::Wheel:
+        return (previous._delta > 0) == (next._delta > 0);
+    case Event::Type::KeyPress:
+        return previous._key == next._key && isNavigationKey(next._key);
+    default:
+        return false;
+    }
+}
+
+bool Tg::InputParser::isNavigationKey(const Key::Code key)
+{
+    switch (key) {
+    case Key::Code::Up:
+    case Key::Code::Down:
+    case Key::Code::Left:
+    case Key::Code::Right:
+    case Key::Code::PageUp:
+    case Key::Code::PageDown:
+        return true;
+    default:
+        return false;
+    }
+}
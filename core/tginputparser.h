@@ -0,0 +1,141 @@
+#pragma once
+
+#include "tgevent.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+
+namespace Tg {
+/*!
+ * \brief Decodes raw keyboard buffer into a list of Events.
+ *
+ * Terminal delivers key presses and mouse events as a single stream of bytes
+ * (escape sequences, UTF-8 characters, control characters). InputParser splits
+ * that stream into separate KeyEvent, MouseEvent, WheelEvent and PasteEvent
+ * objects, so that each input is decoded exactly once, no matter how many
+ * widgets look at it later.
+ *
+ * InputParser is stateful: if the buffer ends in the middle of an escape
+ * sequence, the incomplete part is kept and parsed together with the next
+ * chunk of data passed to parse().
+ *
+ * A lone ESC byte is ambiguous: it can be an Escape key press or the first
+ * byte of an escape sequence which has not fully arrived yet. InputParser
+ * waits escapeTimeout() milliseconds for the rest of the sequence before
+ * reporting Escape key. Terminals which support kitty keyboard protocol
+ * report Escape key as an unambiguous sequence, so no waiting is necessary
+ * there.
+ *
+ * Bracketed paste is collected until its end marker arrives. If no data
+ * arrives for pasteTimeout milliseconds while waiting for it, the text
+ * pasted so far is reported and parsing of regular input resumes.
+ *
+ * This class is internal, it is used by Screen.
+ */
+class InputParser
+{
+public:
+    /*!
+     * Appends \a bytes to internal buffer and returns all Events which could
+     * be fully decoded from it. Each Event is stamped with current time (see
+     * Event::timestamp()).
+     */
+    EventList parse(const QByteArray &bytes);
+
+    /*!
+     * Returns `true` if some bytes are waiting for the rest of an escape
+     * sequence to arrive.
+     */
+    bool hasPendingInput() const;
+
+    /*!
+     * Discards any incomplete input.
+     */
+    void clear();
+
+    /*!
+     * Removes incomplete input from the parser and returns it, so that it can
+     * be parsed by another InputParser.
+     */
+    QByteArray takePendingInput();
+
+    /*!
+     * Returns the time (in milliseconds) InputParser waits for the rest of an
+     * escape sequence before treating ESC byte as Escape key.
+     *
+     * \sa setEscapeTimeout
+     */
+    int escapeTimeout() const;
+
+    /*!
+     * Sets escape timeout to \a milliseconds. Value of 0 (zero) means lone ESC
+     * byte is reported as Escape key immediately, which is fastest but can
+     * split escape sequences arriving in separate chunks (for example over
+     * slow SSH connections).
+     *
+     * \note parse() has to be called again (possibly with empty data) after
+     * the timeout passes for the pending Escape key to be reported.
+     *
+     * \sa escapeTimeout, hasPendingInput
+     */
+    void setEscapeTimeout(const int milliseconds);
+
+    /*!
+     * Default value of escapeTimeout(), in milliseconds.
+     */
+    static const int defaultEscapeTimeout = 50;
+
+    /*!
+     * Time (in milliseconds) without any new data after which an unfinished
+     * bracketed paste is reported as it is.
+     */
+    static const int pasteTimeout = 1000;
+
+    /*!
+     * Merges consecutive, equivalent \a events into single Events and returns
+     * the result:
+     *
+     * \li mouse moves: only the latest position is kept
+     * \li wheel scrolls in the same direction: deltas are summed up
+     * \li repeated navigation keys (arrows, Page Up, Page Down): merged into
+     *     a single KeyEvent with Event::count() equal to number of presses
+     *
+     * This way a burst of input which arrived within a single keyboard poll
+     * (for example a held down arrow key or a window drag) is handled with a
+     * single update of widget state, instead of one update per input.
+     */
+    static EventList compressEvents(const EventList &events);
+
+private:
+    int parseEvent(const int index, EventList *events) const;
+    int parseEscape(const int index, EventList *events) const;
+    int parseCsi(const int index, EventList *events) const;
+    int parseSs3(const int index, EventList *events) const;
+    int parsePaste(const int index, const int begin, EventList *events) const;
+    void appendKeyboardProtocolKey(const QList<QByteArray> &parts,
+                                   const QByteArray &sequence,
+                                   EventList *events) const;
+    int parseCharacter(const int index, EventList *events,
+                       const Key::Modifiers modifiers,
+                       const int prefixLength) const;
+    void appendMouseEvent(const QByteArray &parameters, const char finalByte,
+                          const QByteArray &sequence, EventList *events) const;
+
+    static Key::Modifiers modifiersFromParameter(const int parameter);
+    static bool canMerge(const Event &previous, const Event &next);
+    static bool isNavigationKey(const Key::Code key);
+
+    /*!
+     * Escape sequences longer than this are considered garbage and dropped.
+     */
+    static const int maximumSequenceLength = 64;
+
+    QByteArray _buffer;
+    QElapsedTimer _pendingTimer;
+    int _escapeTimeout = defaultEscapeTimeout;
+    // Length of unfinished paste already searched for the end marker, see
+    // parsePaste()
+    mutable int _scannedPasteLength = 0;
+};
+}
@@ -0,0 +1,129 @@
+#include "tginputreader.h"
+#include "tgterminal.h"
+
+#include <algorithm>
+
+Tg::InputReader::InputReader(QObject *parent) : QThread(parent)
+{
+}
+
+Tg::InputReader::~InputReader()
+{
+    stop();
+}
+
+Tg::EventList Tg::InputReader::takeEvents()
+{
+    EventList result;
+    Event event;
+    while (_queue.pop(&event)) {
+        result.append(event);
+    }
+
+    // Reader thread might be waiting for space in the queue
+    if (result.isEmpty() == false) {
+        QMutexLocker locker(&_queueMutex);
+        _queueNotFull.wakeAll();
+    }
+
+    return result;
+}
+
+bool Tg::InputReader::hasEvents() const
+{
+    return _queue.isEmpty() == false;
+}
+
+void Tg::InputReader::setEscapeTimeout(const int milliseconds)
+{
+    _escapeTimeout = milliseconds;
+}
+
+void Tg::InputReader::setPendingInput(const QByteArray &bytes)
+{
+    _pendingInput = bytes;
+}
+
+QByteArray Tg::InputReader::takePendingInput()
+{
+    QByteArray result;
+    result.swap(_pendingInput);
+    return result;
+}
+
+void Tg::InputReader::stop()
+{
+    requestInterruption();
+
+    {
+        QMutexLocker locker(&_queueMutex);
+        _queueNotFull.wakeAll();
+    }
+
+    wait();
+}
+
+void Tg::InputReader::run()
+{
+    // Parser is only ever touched from this thread
+    InputParser parser;
+    parser.setEscapeTimeout(_escapeTimeout);
+    pushEvents(InputParser::compressEvents(parser.parse(takePendingInput())));
+
+    while (isInterruptionRequested() == false) {
+        parser.setEscapeTimeout(_escapeTimeout);
+
+        // When part of an escape sequence is pending, wake up in time to
+        // report it as Escape key
+        const int timeout = parser.hasPendingInput()?
+                    std::min(parser.escapeTimeout() + 1, int(pollInterval))
+                  : pollInterval;
+
+        QByteArray bytes;
+        if (Terminal::waitForInput(timeout)) {
+            bytes = Terminal::readInput();
+        }
+
+        if (bytes.isEmpty() && parser.hasPendingInput() == false) {
+            continue;
+        }
+
+        pushEvents(InputParser::compressEvents(parser.parse(bytes)));
+    }
+
+    // Handed over to the GUI thread parser, see Screen::setThreadedInput()
+    _pendingInput = parser.takePendingInput();
+}
+
+void Tg::InputReader::pushEvents(const EventList &events)
+{
+    if (events.isEmpty()) {
+        return;
+    }
+
+    for (const Event &event : events) {
+        pushEvent(event);
+    }
+
+    emit eventsAvailable();
+}
+
+void Tg::InputReader::pushEvent(const Event &event)
+{
+    if (_queue.push(event)) {
+        return;
+    }
+
+    // GUI thread does not keep up: let it know once, then wait until it
+    // takes some events, instead of dropping input
+    emit eventsAvailable();
+
+    QMutexLocker locker(&_queueMutex);
+    while (_queue.push(event) == false) {
+        if (isInterruptionRequested()) {
+            return;
+        }
+
+        _queueNotFull.wait(&_queueMutex, pollInterval);
+    }
+}
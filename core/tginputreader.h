@@ -0,0 +1,116 @@
+#pragma once
+
+#include "tgeventqueue.h"
+#include "tginputparser.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+
+namespace Tg {
+/*!
+ * \brief Reads and decodes terminal input in a separate thread.
+ *
+ * By default, Screen polls keyboard buffer from the GUI thread. When GUI
+ * thread is busy (for example during a large model reset or a slow layout),
+ * input is left waiting in the terminal, and the moment it was typed is lost.
+ *
+ * InputReader blocks on standard input in its own thread, decodes it with an
+ * InputParser as soon as it arrives (so that Event::timestamp() is accurate)
+ * and passes the events to the GUI thread through a lock-free EventQueue.
+ * eventsAvailable() signal is emitted whenever new events are waiting to be
+ * taken with takeEvents().
+ *
+ * This class is internal, it is used by Screen. See Screen::threadedInput.
+ */
+class InputReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * Constructs InputReader as a child of \a parent. The thread is not
+     * started, call start() to begin reading input.
+     */
+    InputReader(QObject *parent = nullptr);
+
+    /*!
+     * Stops the thread.
+     */
+    ~InputReader();
+
+    /*!
+     * Removes all decoded events from the queue and returns them.
+     *
+     * \warning Call only from the thread InputReader object lives in (usually
+     * GUI thread).
+     */
+    EventList takeEvents();
+
+    /*!
+     * Returns `true` if there are decoded events waiting in the queue.
+     */
+    bool hasEvents() const;
+
+    /*!
+     * Sets escape timeout of the internal InputParser. Can be called while the
+     * thread is running.
+     *
+     * \sa InputParser::setEscapeTimeout
+     */
+    void setEscapeTimeout(const int milliseconds);
+
+    /*!
+     * Sets incomplete input (like part of an escape sequence) received before
+     * the thread started. It is parsed together with the first input read by
+     * the thread, so that switching to threaded input does not lose it.
+     *
+     * \warning Call before start().
+     *
+     * \sa InputParser::takePendingInput
+     */
+    void setPendingInput(const QByteArray &bytes);
+
+    /*!
+     * Returns incomplete input left when the thread stopped, and clears it.
+     *
+     * \warning Call after stop().
+     */
+    QByteArray takePendingInput();
+
+    /*!
+     * Asks the thread to stop and waits until it does.
+     */
+    void stop();
+
+signals:
+    /*!
+     * Emitted (from the reader thread) after a batch of new events has been
+     * added to the queue.
+     */
+    void eventsAvailable() const;
+
+protected:
+    void run() override;
+
+private:
+    void pushEvents(const EventList &events);
+    void pushEvent(const Event &event);
+
+    /*!
+     * Maximum time (in milliseconds) the thread waits for input before
+     * checking whether it has been asked to stop.
+     */
+    static const int pollInterval = 100;
+
+    EventQueue _queue;
+    // Used only to sleep while the queue is full, see pushEvent()
+    QMutex _queueMutex;
+    QWaitCondition _queueNotFull;
+    QByteArray _pendingInput;
+    std::atomic<int> _escapeTimeout = { InputParser::defaultEscapeTimeout };
+};
+}
@@ -3,6 +3,7 @@
 #include "tgcommand.h"
 
 #include <QByteArray>
+#include <QFlags>
 
 namespace Tg {
 /*!
@@ -78,5 +79,63 @@ const QByteArray ctrlC = "\003";
  * Ctrl+D
  */
 const QByteArray ctrlD = "\004";
+
+/*!
+ * Decoded key codes, as reported by KeyEvent::key().
+ *
+ * InputParser translates raw keyboard buffer (the byte sequences defined
+ * above) into these codes, so that widgets do not have to scan the buffer
+ * themselves.
+ */
+enum class Code {
+    //! Sequence was not recognized. Raw bytes are in Event::sequence()
+    Unknown,
+    //! A printable character, see KeyEvent::text()
+    Character,
+    Space,
+    Escape,
+    Tab,
+    //! Shift+Tab
+    Backtab,
+    //! Both Key::enter and Key::ret are reported as Enter
+    Enter,
+    Backspace,
+    Insert,
+    Delete,
+    Home,
+    End,
+    PageUp,
+    PageDown,
+    Up,
+    Down,
+    Right,
+    Left,
+    F1,
+    F2,
+    F3,
+    F4,
+    F5,
+    F6,
+    F7,
+    F8,
+    F9,
+    F10,
+    F11,
+    F12
+};
+
+/*!
+ * Keyboard modifiers held down while a key was pressed (or while mouse event
+ * occurred).
+ */
+enum class Modifier {
+    NoModifier = 0x00,
+    Shift = 0x01,
+    Alt = 0x02,
+    Ctrl = 0x04,
+    Meta = 0x08
+};
+Q_DECLARE_FLAGS(Modifiers, Modifier)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Modifiers)
 }
 }
@@ -0,0 +1,269 @@
+#include "tgkeysequence.h"
+
+#include <QStringList>
+
+namespace {
+struct KeyName {
+    const char *name;
+    Tg::Key::Code key;
+};
+
+const KeyName keyNames[] = {
+    { "esc", Tg::Key::Code::Escape },
+    { "escape", Tg::Key::Code::Escape },
+    { "tab", Tg::Key::Code::Tab },
+    { "backtab", Tg::Key::Code::Backtab },
+    { "enter", Tg::Key::Code::Enter },
+    { "return", Tg::Key::Code::Enter },
+    { "backspace", Tg::Key::Code::Backspace },
+    { "space", Tg::Key::Code::Space },
+    { "ins", Tg::Key::Code::Insert },
+    { "insert", Tg::Key::Code::Insert },
+    { "del", Tg::Key::Code::Delete },
+    { "delete", Tg::Key::Code::Delete },
+    { "home", Tg::Key::Code::Home },
+    { "end", Tg::Key::Code::End },
+    { "pgup", Tg::Key::Code::PageUp },
+    { "pageup", Tg::Key::Code::PageUp },
+    { "pgdown", Tg::Key::Code::PageDown },
+    { "pagedown", Tg::Key::Code::PageDown },
+    { "up", Tg::Key::Code::Up },
+    { "down", Tg::Key::Code::Down },
+    { "left", Tg::Key::Code::Left },
+    { "right", Tg::Key::Code::Right },
+    { "f1", Tg::Key::Code::F1 },
+    { "f2", Tg::Key::Code::F2 },
+    { "f3", Tg::Key::Code::F3 },
+    { "f4", Tg::Key::Code::F4 },
+    { "f5", Tg::Key::Code::F5 },
+    { "f6", Tg::Key::Code::F6 },
+    { "f7", Tg::Key::Code::F7 },
+    { "f8", Tg::Key::Code::F8 },
+    { "f9", Tg::Key::Code::F9 },
+    { "f10", Tg::Key::Code::F10 },
+    { "f11", Tg::Key::Code::F11 },
+    { "f12", Tg::Key::Code::F12 }
+};
+}
+
+Tg::KeyStroke::KeyStroke()
+{
+}
+
+Tg::KeyStroke::KeyStroke(const Key::Code key, const Key::Modifiers modifiers)
+    : _key(key), _modifiers(modifiers)
+{
+    normalize();
+}
+
+Tg::KeyStroke::KeyStroke(const QString &text, const Key::Modifiers modifiers)
+    : _key(Key::Code::Character), _text(text), _modifiers(modifiers)
+{
+    normalize();
+}
+
+Tg::KeyStroke Tg::KeyStroke::fromEvent(const KeyEvent &event)
+{
+    if (event.key() == Key::Code::Character) {
+        return KeyStroke(event.text(), event.modifiers());
+    }
+
+    return KeyStroke(event.key(), event.modifiers());
+}
+
+Tg::KeyStroke Tg::KeyStroke::fromString(const QString &string)
+{
+    // "+" on its own (or at the end, as in "Ctrl++") is the key, not
+    // a separator
+    QString keyName = string;
+    Key::Modifiers modifiers;
+
+    while (true) {
+        const int separator = keyName.indexOf(QLatin1Char('+'));
+        if (separator <= 0 || separator == (keyName.size() - 1)) {
+            break;
+        }
+
+        const QString modifier = keyName.left(separator).toLower();
+        if (modifier == QStringLiteral("ctrl")) {
+            modifiers |= Key::Modifier::Ctrl;
+        } else if (modifier == QStringLiteral("alt")) {
+            modifiers |= Key::Modifier::Alt;
+        } else if (modifier == QStringLiteral("shift")) {
+            modifiers |= Key::Modifier::Shift;
+        } else if (modifier == QStringLiteral("meta")) {
+            modifiers |= Key::Modifier::Meta;
+        } else {
+            return KeyStroke();
+        }
+
+        keyName = keyName.mid(separator + 1);
+    }
+
+    if (keyName.size() == 1) {
+        if (keyName == QStringLiteral(" ")) {
+            return KeyStroke(Key::Code::Space, modifiers);
+        }
+
+        return KeyStroke(keyName, modifiers);
+    }
+
+    const QString lowerName = keyName.toLower();
+    for (const KeyName &name : keyNames) {
+        if (lowerName == QLatin1String(name.name)) {
+            return KeyStroke(name.key, modifiers);
+        }
+    }
+
+    // Multi-byte characters (surrogate pairs)
+    if (keyName.size() == 2 && keyName.at(0).isHighSurrogate()) {
+        return KeyStroke(keyName, modifiers);
+    }
+
+    return KeyStroke();
+}
+
+Tg::Key::Code Tg::KeyStroke::key() const
+{
+    return _key;
+}
+
+QString Tg::KeyStroke::text() const
+{
+    return _text;
+}
+
+Tg::Key::Modifiers Tg::KeyStroke::modifiers() const
+{
+    return _modifiers;
+}
+
+bool Tg::KeyStroke::isValid() const
+{
+    return _key != Key::Code::Unknown;
+}
+
+bool Tg::KeyStroke::operator==(const KeyStroke &other) const
+{
+    return _key == other._key
+            && _modifiers == other._modifiers
+            && _text == other._text;
+}
+
+bool Tg::KeyStroke::operator!=(const KeyStroke &other) const
+{
+    return !(*this == other);
+}
+
+void Tg::KeyStroke::normalize()
+{
+    if (_key == Key::Code::Character && _text == QStringLiteral(" ")) {
+        _key = Key::Code::Space;
+    }
+
+    if (_key != Key::Code::Character) {
+        _text.clear();
+
+        // Legacy terminals send Shift+Tab as Backtab (CSI Z)
+        if (_key == Key::Code::Tab
+                && _modifiers.testFlag(Key::Modifier::Shift)) {
+            _key = Key::Code::Backtab;
+        }
+
+        if (_key == Key::Code::Backtab) {
+            // Shift is implied
+            _modifiers.setFlag(Key::Modifier::Shift, false);
+        }
+        return;
+    }
+
+    if (_text.isEmpty()) {
+        _key = Key::Code::Unknown;
+        return;
+    }
+
+    // Shift is expressed through character case. Terminals can't report
+    // Ctrl+Shift+letter in legacy mode, so Ctrl+letter is always lower case
+    if (_modifiers.testFlag(Key::Modifier::Shift)) {
+        _text = _text.toUpper();
+        _modifiers.setFlag(Key::Modifier::Shift, false);
+    } else if (_modifiers.testFlag(Key::Modifier::Ctrl)) {
+        _text = _text.toLower();
+    }
+}
+
+#if QT_VERSION_MAJOR < 6
+uint Tg::qHash(const KeyStroke &stroke, uint seed)
+#else
+size_t Tg::qHash(const KeyStroke &stroke, size_t seed)
+#endif
+{
+    return ::qHash(stroke.text(), seed)
+            ^ ::qHash(int(stroke.key()), seed)
+            ^ ::qHash(int(stroke.modifiers()) << 8, seed);
+}
+
+Tg::KeySequence::KeySequence()
+{
+}
+
+Tg::KeySequence::KeySequence(const QString &sequence)
+{
+    QString normalized = sequence;
+    normalized.replace(QLatin1Char(','), QLatin1Char(' '));
+#if QT_VERSION_MAJOR < 6
+    const QStringList parts = normalized.split(QLatin1Char(' '), QString::SkipEmptyParts);
+#else
+    const QStringList parts = normalized.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+#endif
+
+    for (const QString &part : parts) {
+        const KeyStroke stroke = KeyStroke::fromString(part);
+        if (stroke.isValid() == false) {
+            _strokes.clear();
+            return;
+        }
+
+        _strokes.append(stroke);
+    }
+}
+
+Tg::KeySequence::KeySequence(const char *sequence)
+    : KeySequence(QString::fromUtf8(sequence))
+{
+}
+
+Tg::KeySequence::KeySequence(std::initializer_list<KeyStroke> strokes)
+    : _strokes(strokes)
+{
+}
+
+int Tg::KeySequence::count() const
+{
+    return _strokes.size();
+}
+
+bool Tg::KeySequence::isEmpty() const
+{
+    return _strokes.isEmpty();
+}
+
+Tg::KeyStroke Tg::KeySequence::at(const int index) const
+{
+    return _strokes.at(index);
+}
+
+QVector<Tg::KeyStroke> Tg::KeySequence::strokes() const
+{
+    return _strokes;
+}
+
+bool Tg::KeySequence::operator==(const KeySequence &other) const
+{
+    return _strokes == other._strokes;
+}
+
+bool Tg::KeySequence::operator!=(const KeySequence &other) const
+{
+    return !(*this == other);
+}
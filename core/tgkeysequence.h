@@ -0,0 +1,123 @@
+#pragma once
+
+#include "tgkey.h"
+#include "tgevent.h"
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMetaType>
+
+#include <initializer_list>
+
+namespace Tg {
+/*!
+ * \brief A single key combination: a key plus modifiers held down with it.
+ *
+ * KeyStroke is normalized on construction, so that the same combination
+ * compares equal no matter how the terminal encoded it. For example, Shift is
+ * folded into the case of a printable character, and letters pressed with Ctrl
+ * are always lower case (legacy terminals cannot report the difference).
+ *
+ * \sa KeySequence
+ */
+class KeyStroke
+{
+public:
+    /*!
+     * Constructs an invalid KeyStroke.
+     */
+    KeyStroke();
+
+    /*!
+     * Constructs a KeyStroke of a non-printable \a key (for example
+     * Key::Code::F1) pressed with \a modifiers.
+     */
+    KeyStroke(const Key::Code key,
+              const Key::Modifiers modifiers = Key::Modifier::NoModifier);
+
+    /*!
+     * Constructs a KeyStroke of a printable character \a text pressed with
+     * \a modifiers.
+     */
+    KeyStroke(const QString &text,
+              const Key::Modifiers modifiers = Key::Modifier::NoModifier);
+
+    /*!
+     * Returns KeyStroke matching key press \a event.
+     */
+    static KeyStroke fromEvent(const KeyEvent &event);
+
+    /*!
+     * Parses a single key combination, like `Ctrl+x`, `Alt+Left`, `F5` or
+     * `q`. Modifiers (`Ctrl`, `Alt`, `Shift`, `Meta`) and key name are joined
+     * with `+`. Returns an invalid KeyStroke if \a string cannot be parsed.
+     */
+    static KeyStroke fromString(const QString &string);
+
+    Key::Code key() const;
+    QString text() const;
+    Key::Modifiers modifiers() const;
+
+    /*!
+     * Returns `false` for default-constructed KeyStroke, or one which could
+     * not be parsed.
+     */
+    bool isValid() const;
+
+    bool operator==(const KeyStroke &other) const;
+    bool operator!=(const KeyStroke &other) const;
+
+private:
+    void normalize();
+
+    Key::Code _key = Key::Code::Unknown;
+    QString _text;
+    Key::Modifiers _modifiers = Key::Modifier::NoModifier;
+};
+
+#if QT_VERSION_MAJOR < 6
+uint qHash(const KeyStroke &stroke, uint seed = 0);
+#else
+size_t qHash(const KeyStroke &stroke, size_t seed = 0);
+#endif
+
+/*!
+ * \brief A sequence of KeyStroke objects, used to define a Shortcut.
+ *
+ * Most shortcuts consist of a single KeyStroke, but multi-key chords (like
+ * `Ctrl+x Ctrl+s`) are supported as well.
+ */
+class KeySequence
+{
+public:
+    /*!
+     * Constructs an empty KeySequence.
+     */
+    KeySequence();
+
+    /*!
+     * Parses \a sequence: key combinations (see KeyStroke::fromString())
+     * separated by spaces or commas, for example: `Ctrl+x, Ctrl+s`.
+     *
+     * If any part of \a sequence cannot be parsed, the resulting
+     * KeySequence is empty.
+     */
+    KeySequence(const QString &sequence);
+    KeySequence(const char *sequence);
+    KeySequence(std::initializer_list<KeyStroke> strokes);
+
+    int count() const;
+    bool isEmpty() const;
+    KeyStroke at(const int index) const;
+    QVector<KeyStroke> strokes() const;
+
+    bool operator==(const KeySequence &other) const;
+    bool operator!=(const KeySequence &other) const;
+
+private:
+    QVector<KeyStroke> _strokes;
+};
+}
+
+Q_DECLARE_METATYPE(Tg::KeySequence)
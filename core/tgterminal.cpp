@@ -1,4 +1,7 @@
 #include "tgterminal.h"
+#include "tgcommand.h"
+
+#include <QTextStream>
 
 Tg::Terminal *Tg::Terminal::_globalTerminal = nullptr;
 
@@ -8,6 +11,8 @@ Tg::Terminal::Terminal(QObject *parent) : QObject(parent)
     _size = terminalWindowSize();
     registerSignalHandler();
     enableMouseTracking();
+    enableBracketedPaste();
+    queryKeyboardProtocol();
 }
 
 Tg::Terminal::~Terminal()
@@ -15,6 +20,14 @@ Tg::Terminal::~Terminal()
     if (_isMouseReporting) {
         disableMouseTracking();
     }
+
+    if (_isBracketedPaste) {
+        disableBracketedPaste();
+    }
+
+    if (_isKeyboardProtocol) {
+        disableKeyboardProtocol();
+    }
 }
 
 Tg::Terminal *Tg::Terminal::globalTerminal()
@@ -40,3 +53,46 @@ bool Tg::Terminal::mouseTracking() const
     return _isMouseReporting;
 }
 
+bool Tg::Terminal::bracketedPaste() const
+{
+    return _isBracketedPaste;
+}
+
+void Tg::Terminal::enableBracketedPaste()
+{
+    QTextStream stream(stdout);
+    stream << Command::bracketedPasteOn;
+    _isBracketedPaste = true;
+}
+
+void Tg::Terminal::disableBracketedPaste()
+{
+    QTextStream stream(stdout);
+    stream << Command::bracketedPasteOff;
+    _isBracketedPaste = false;
+}
+
+void Tg::Terminal::queryKeyboardProtocol()
+{
+    QTextStream stream(stdout);
+    stream << Command::keyboardProtocolQuery;
+}
+
+bool Tg::Terminal::keyboardProtocol() const
+{
+    return _isKeyboardProtocol;
+}
+
+void Tg::Terminal::enableKeyboardProtocol()
+{
+    QTextStream stream(stdout);
+    stream << Command::keyboardProtocolPush;
+    _isKeyboardProtocol = true;
+}
+
+void Tg::Terminal::disableKeyboardProtocol()
+{
+    QTextStream stream(stdout);
+    stream << Command::keyboardProtocolPop;
+    _isKeyboardProtocol = false;
+}
@@ -3,6 +3,7 @@
 #include <QPoint>
 #include <QSize>
 #include <QString>
+#include <QByteArray>
 #include <QObject>
 
 namespace Tg {
@@ -83,10 +84,51 @@ public:
      */
     static int getChar();
 
+    /*!
+     * Blocks until keyboard buffer is not empty, or until \a timeout
+     * (in milliseconds) passes. Returns `true` if input is available.
+     *
+     * \sa readInput
+     */
+    static bool waitForInput(const int timeout);
+
+    /*!
+     * Reads all bytes currently available in keyboard buffer and returns them.
+     * Does not block.
+     *
+     * \sa waitForInput, keyboardBufferSize
+     */
+    static QByteArray readInput();
+
     bool mouseTracking() const;
     void enableMouseTracking();
     void disableMouseTracking();
 
+    /*!
+     * Returns `true` if bracketed paste mode is on. In this mode, terminal
+     * marks the beginning and end of pasted text, which allows InputParser
+     * to deliver whole paste as a single PasteEvent.
+     */
+    bool bracketedPaste() const;
+    void enableBracketedPaste();
+    void disableBracketedPaste();
+
+    /*!
+     * Asks the terminal whether it supports kitty keyboard protocol. If it
+     * does, the reply is reported by InputParser as an Event of
+     * Event::Type::KeyboardProtocolReply, and enableKeyboardProtocol() can be
+     * called.
+     */
+    void queryKeyboardProtocol();
+
+    /*!
+     * Returns `true` if kitty keyboard protocol is enabled. In this mode
+     * Escape key and modifier combinations are reported unambiguously.
+     */
+    bool keyboardProtocol() const;
+    void enableKeyboardProtocol();
+    void disableKeyboardProtocol();
+
 signals:
     /*!
      * Emitted when terminal window changes size to \a size.
@@ -100,6 +142,8 @@ private:
     static const int standardInputIndex = 0;
     const QSize _defaultSize = QSize(80, 24);
     bool _isMouseReporting = false;
+    bool _isBracketedPaste = false;
+    bool _isKeyboardProtocol = false;
     QSize _size;
 };
 
@@ -114,8 +158,13 @@ public:
     /*!
      * Disables echo mode in terminal. All key strokes are intercepted by
      * Tg::Terminal instead.
+     *
+     * Keys which send signals (Ctrl+C, Ctrl+Z, Ctrl+\\) keep doing so, unless
+     * \a interceptSignals is `true`. Then they reach the application as key
+     * presses: Screen still quits on Ctrl+C, but the application can no
+     * longer be suspended, and a busy event loop can not be interrupted.
      */
-    RawTerminalLocker();
+    explicit RawTerminalLocker(const bool interceptSignals = false);
 
     /*!
      * Enables echo mode in terminal.
@@ -11,6 +11,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <termios.h>
+#include <poll.h>
 
 static struct sigaction sigIntHandler;
 struct termios previousTermios;
@@ -58,6 +59,32 @@ int Tg::Terminal::getChar()
     return getchar();
 }
 
+bool Tg::Terminal::waitForInput(const int timeout)
+{
+    pollfd descriptor;
+    descriptor.fd = standardInputIndex;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    return poll(&descriptor, 1, timeout) > 0
+            && (descriptor.revents & POLLIN);
+}
+
+QByteArray Tg::Terminal::readInput()
+{
+    QByteArray result;
+    const int size = keyboardBufferSize();
+    if (size <= 0) {
+        return result;
+    }
+
+    // Read straight from the file descriptor, bypassing stdio buffer which
+    // poll() does not know about
+    result.resize(size);
+    const ssize_t count = read(standardInputIndex, result.data(), size);
+    result.resize(count > 0? int(count) : 0);
+    return result;
+}
+
 void Tg::Terminal::registerSignalHandler()
 {
     sigIntHandler.sa_handler = linuxSignalHandler;
@@ -97,13 +124,16 @@ void disableRawMode()
     }
 }
 
-Tg::RawTerminalLocker::RawTerminalLocker()
+Tg::RawTerminalLocker::RawTerminalLocker(const bool interceptSignals)
 {
     tcgetattr(STDIN_FILENO, &previousTermios);
     //atexit(disableRawMode);
 
     struct termios raw = previousTermios;
     raw.c_lflag &= ~(ECHO | ICANON);
+    if (interceptSignals) {
+        raw.c_lflag &= ~(ISIG | IEXTEN);
+    }
 
     const int result = tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
     if (result != 0) {
@@ -32,6 +32,31 @@ int Tg::Terminal::getChar()
     return _getch();
 }
 
+bool Tg::Terminal::waitForInput(const int timeout)
+{
+    // Console handle is also signalled by events which _kbhit() ignores
+    // (focus, resize), so poll keyboard buffer instead of waiting on it
+    const int step = 10;
+    for (int waited = 0; waited < timeout; waited += step) {
+        if (_kbhit()) {
+            return true;
+        }
+
+        Sleep(step);
+    }
+
+    return _kbhit() != 0;
+}
+
+QByteArray Tg::Terminal::readInput()
+{
+    QByteArray result;
+    while (_kbhit()) {
+        result.append(char(_getch()));
+    }
+    return result;
+}
+
 void Tg::Terminal::registerSignalHandler()
 {
 }
@@ -51,8 +76,10 @@ void Tg::Terminal::disableMouseTracking()
 }
 
 #include <iostream>
-Tg::RawTerminalLocker::RawTerminalLocker()
+Tg::RawTerminalLocker::RawTerminalLocker(const bool interceptSignals)
 {
+    Q_UNUSED(interceptSignals)
+
     // This is Windowese for "UTF-8, sorta where we feel like it"
     system("chcp 65001");
     system("cls");
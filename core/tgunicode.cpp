@@ -0,0 +1,325 @@
+#include "tgunicode.h"
+
+#include <QChar>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+
+#include <iterator>
+
+namespace {
+constexpr char32_t maxCodePoint = 0x10FFFF;
+constexpr char32_t zeroWidthJoiner = 0x200D;
+
+struct Range {
+    char32_t first;
+    char32_t last;
+};
+
+/*!
+ * Code points with East Asian Width property W (wide) or F (fullwidth).
+ * Supplementary Ideographic Planes are handled separately.
+ */
+const Range wideRanges[] = {
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A },
+    { 0x23E9, 0x23EC }, { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 },
+    { 0x25FD, 0x25FE }, { 0x2614, 0x2615 }, { 0x2648, 0x2653 },
+    { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+    { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 },
+    { 0x26CE, 0x26CE }, { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA },
+    { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 }, { 0x26FA, 0x26FA },
+    { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+    { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E },
+    { 0x2753, 0x2755 }, { 0x2757, 0x2757 }, { 0x2795, 0x2797 },
+    { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF }, { 0x2B1B, 0x2B1C },
+    { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x303E },
+    { 0x3041, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF },
+    { 0xA000, 0xA4CF }, { 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 },
+    { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 }, { 0xFE30, 0xFE6F },
+    { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+    { 0x17000, 0x18CFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 },
+    { 0x1F0CF, 0x1F0CF }, { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A },
+    { 0x1F200, 0x1F251 }, { 0x1F300, 0x1F64F }, { 0x1F680, 0x1F6FF },
+    { 0x1F7E0, 0x1F7EB }, { 0x1F90C, 0x1F9FF }, { 0x1FA70, 0x1FAFF }
+};
+
+/*!
+ * Zero-width code points which are not combining marks: Hangul Jamo vowels
+ * and final consonants (which combine with preceding leading consonant into
+ * a single syllable), zero-width spaces and joiners, variation selectors and
+ * tags.
+ */
+const Range zeroWidthRanges[] = {
+    { 0x1160, 0x11FF }, { 0x200B, 0x200F }, { 0x2060, 0x2064 },
+    { 0xD7B0, 0xD7FF }, { 0xFE00, 0xFE0F }, { 0xFEFF, 0xFEFF },
+    { 0xE0000, 0xE0FFF }
+};
+
+bool isInRanges(const char32_t codePoint, const Range *begin, const Range *end)
+{
+    for (const Range *range = begin; range != end; ++range) {
+        if (codePoint >= range->first && codePoint <= range->last) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isControl(const char32_t codePoint)
+{
+    return codePoint < 0x20 || (codePoint >= 0x7F && codePoint <= 0x9F);
+}
+
+bool isRegionalIndicator(const char32_t codePoint)
+{
+    return codePoint >= 0x1F1E6 && codePoint <= 0x1F1FF;
+}
+
+bool isEmojiModifier(const char32_t codePoint)
+{
+    return codePoint >= 0x1F3FB && codePoint <= 0x1F3FF;
+}
+
+/*!
+ * Computes width of \a codePoint from Unicode properties. Slow, used only
+ * to fill WidthTable.
+ */
+quint8 computeWidth(const char32_t codePoint)
+{
+    if (isControl(codePoint)) {
+        return 0;
+    }
+
+    // Supplementary and Tertiary Ideographic Planes
+    if ((codePoint >= 0x20000 && codePoint <= 0x2FFFD)
+            || (codePoint >= 0x30000 && codePoint <= 0x3FFFD)) {
+        return 2;
+    }
+
+    // Only planes 0, 1 and 14 contain characters of width other than 1,
+    // there is no need to query Qt about the rest
+    if (codePoint >= 0x20000 && (codePoint < 0xE0000 || codePoint > 0xE0FFF)) {
+        return 1;
+    }
+
+    if (isInRanges(codePoint, std::begin(zeroWidthRanges),
+                   std::end(zeroWidthRanges))) {
+        return 0;
+    }
+
+    switch (QChar::category(uint(codePoint))) {
+    case QChar::Mark_NonSpacing:
+    case QChar::Mark_Enclosing:
+        return 0;
+    case QChar::Other_Format:
+        // Soft hyphen is displayed by terminals
+        return (codePoint == 0x00AD)? 1 : 0;
+    default:
+        break;
+    }
+
+    if (isInRanges(codePoint, std::begin(wideRanges), std::end(wideRanges))) {
+        return 2;
+    }
+
+    return 1;
+}
+
+/*!
+ * Two-level lookup table of code point widths.
+ *
+ * Code points are split into blocks of 256. First level maps a block number
+ * to an offset of that block's widths in the second level. Most blocks are
+ * identical (all narrow, or all wide), so they are stored only once and the
+ * whole table takes a few tens of kilobytes.
+ */
+class WidthTable
+{
+public:
+    WidthTable()
+    {
+        constexpr int blockCount = (maxCodePoint >> blockBits) + 1;
+        _index.reserve(blockCount);
+
+        QHash<QByteArray, int> uniqueBlocks;
+        QByteArray block(blockSize, 0);
+        for (int blockNumber = 0; blockNumber < blockCount; ++blockNumber) {
+            const char32_t first = char32_t(blockNumber) << blockBits;
+            for (int i = 0; i < blockSize; ++i) {
+                block[i] = char(computeWidth(first + char32_t(i)));
+            }
+
+            int offset = uniqueBlocks.value(block, -1);
+            if (offset == -1) {
+                offset = int(_widths.size());
+                uniqueBlocks.insert(block, offset);
+                _widths.append(block);
+            }
+            _index.append(offset);
+        }
+    }
+
+    int width(const char32_t codePoint) const
+    {
+        if (codePoint > maxCodePoint) {
+            return 1;
+        }
+
+        return _widths.at(_index.at(codePoint >> blockBits)
+                          + int(codePoint & blockMask));
+    }
+
+private:
+    static constexpr int blockBits = 8;
+    static constexpr int blockSize = 1 << blockBits;
+    static constexpr char32_t blockMask = blockSize - 1;
+
+    QVector<int> _index;
+    QByteArray _widths;
+};
+
+const WidthTable &widthTable()
+{
+    static const WidthTable table;
+    return table;
+}
+
+/*!
+ * Returns `true` if \a codePoint does not start a new grapheme cluster, but
+ * extends the previous one.
+ */
+bool isExtender(const char32_t codePoint)
+{
+    if (isControl(codePoint)) {
+        return false;
+    }
+
+    return isEmojiModifier(codePoint)
+            || widthTable().width(codePoint) == 0;
+}
+}
+
+int Tg::Unicode::codePointWidth(const char32_t codePoint)
+{
+    return widthTable().width(codePoint);
+}
+
+char32_t Tg::Unicode::codePointAt(const QString &text, const int position,
+                                  int *length)
+{
+    const QChar character = text.at(position);
+    if (character.isHighSurrogate() && (position + 1) < text.size()) {
+        const QChar low = text.at(position + 1);
+        if (low.isLowSurrogate()) {
+            if (length) {
+                *length = 2;
+            }
+            return char32_t(QChar::surrogateToUcs4(character, low));
+        }
+    }
+
+    if (length) {
+        *length = 1;
+    }
+    return char32_t(character.unicode());
+}
+
+int Tg::Unicode::nextGraphemeBoundary(const QString &text, const int position)
+{
+    const int size = int(text.size());
+    if (position >= size) {
+        return size;
+    }
+
+    int length = 0;
+    const char32_t base = codePointAt(text, position, &length);
+    int boundary = position + length;
+
+    // Controls (including line breaks) are always clusters of their own
+    if (isControl(base)) {
+        return boundary;
+    }
+
+    bool canPairRegionalIndicator = isRegionalIndicator(base);
+    bool isAfterJoiner = false;
+    while (boundary < size) {
+        const char32_t codePoint = codePointAt(text, boundary, &length);
+        if (isControl(codePoint)) {
+            break;
+        }
+
+        if (isAfterJoiner) {
+            isAfterJoiner = false;
+        } else if (canPairRegionalIndicator && isRegionalIndicator(codePoint)) {
+            canPairRegionalIndicator = false;
+        } else if (isExtender(codePoint)) {
+            isAfterJoiner = (codePoint == zeroWidthJoiner);
+            canPairRegionalIndicator = false;
+        } else {
+            break;
+        }
+
+        boundary += length;
+    }
+
+    return boundary;
+}
+
+int Tg::Unicode::previousGraphemeBoundary(const QString &text,
+                                          const int position)
+{
+    if (position <= 0) {
+        return 0;
+    }
+
+    // Step back to a code point which surely starts a cluster, then walk
+    // forward cluster by cluster
+    int start = qMin(position, int(text.size()));
+    while (start > 0) {
+        const bool isSurrogatePair = start >= 2
+                && text.at(start - 1).isLowSurrogate()
+                && text.at(start - 2).isHighSurrogate();
+        start -= isSurrogatePair? 2 : 1;
+
+        const char32_t codePoint = codePointAt(text, start);
+        if (isExtender(codePoint) || isRegionalIndicator(codePoint)) {
+            continue;
+        }
+
+        if (start > 0 && text.at(start - 1).unicode() == zeroWidthJoiner) {
+            continue;
+        }
+
+        break;
+    }
+
+    int boundary = start;
+    while (true) {
+        const int next = nextGraphemeBoundary(text, boundary);
+        if (next >= position) {
+            return boundary;
+        }
+        boundary = next;
+    }
+}
+
+int Tg::Unicode::graphemeWidth(const QString &text, const int position)
+{
+    if (position < 0 || position >= text.size()) {
+        return 0;
+    }
+
+    // Width of a cluster is the width of its base character: everything
+    // which follows it is drawn in the same cell(s)
+    return codePointWidth(codePointAt(text, position));
+}
+
+int Tg::Unicode::width(const QString &text)
+{
+    int result = 0;
+    const int size = int(text.size());
+    for (int i = 0; i < size; i = nextGraphemeBoundary(text, i)) {
+        result += graphemeWidth(text, i);
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+
+namespace Tg {
+/*!
+ * Terminal display width and grapheme cluster segmentation.
+ *
+ * Terminals do not draw one QChar per column: characters outside of Basic
+ * Multilingual Plane take two QChars (a surrogate pair), combining marks take
+ * no column at all and East Asian wide characters (CJK, Hangul, Kana, most
+ * emoji) take two columns. These functions are used by widgets to find out
+ * which text ends up in which terminal cell.
+ *
+ * Width lookup is a two-level table, built once on first use, so it is cheap
+ * enough to call for every character during layout.
+ */
+namespace Unicode {
+/*!
+ * Returns number of terminal columns taken by \a codePoint: `0` for control
+ * characters, combining marks and other zero-width characters, `2` for East
+ * Asian wide and fullwidth characters and `1` for everything else.
+ */
+int codePointWidth(const char32_t codePoint);
+
+/*!
+ * Returns code point starting at \a position in \a text, decoding surrogate
+ * pairs. If \a length is not `nullptr`, it is set to the number of QChars
+ * taken by the code point (`1` or `2`).
+ */
+char32_t codePointAt(const QString &text, const int position,
+                     int *length = nullptr);
+
+/*!
+ * Returns position in \a text where grapheme cluster starting at
+ * \a position ends - that is, where the next user-perceived character
+ * starts.
+ *
+ * A cluster is a base character followed by combining marks, variation
+ * selectors, emoji modifiers and zero-width joiner sequences, or a pair of
+ * regional indicators (a flag). This is a simplified version of extended
+ * grapheme cluster rules of Unicode Standard Annex #29, which is good enough
+ * for terminal output.
+ */
+int nextGraphemeBoundary(const QString &text, const int position);
+
+/*!
+ * Returns position in \a text where grapheme cluster ending at \a position
+ * starts.
+ *
+ * \sa nextGraphemeBoundary
+ */
+int previousGraphemeBoundary(const QString &text, const int position);
+
+/*!
+ * Returns number of terminal columns taken by grapheme cluster starting at
+ * \a position in \a text.
+ */
+int graphemeWidth(const QString &text, const int position);
+
+/*!
+ * Returns number of terminal columns taken by \a text.
+ *
+ * \note Line breaks are not taken into account: width of the whole \a text
+ * is returned, as if it was a single line.
+ */
+int width(const QString &text);
+}
+}
@@ -9,6 +9,7 @@
 #include <widgets/tgscrollbar.h>
 #include <widgets/tgscrollarea.h>
 #include <widgets/tglistview.h>
+#include <widgets/tgitemgrid.h>
 #include <models/tgcheckablestringlistmodel.h>
 
 Tg::CheckableStringList colorData(const QStringList &strings)
@@ -105,5 +106,20 @@ int main(int argc, char *argv[])
     listView.setModel(model);
     listView.show();
 
+    Tg::ItemGrid statusGrid(&screen);
+    statusGrid.setPosition(QPoint(22, 12));
+    statusGrid.setSize(QSize(22, 7));
+    statusGrid.setCellSize(QSize(2, 1));
+
+    QVector<Tg::GridItem> statuses(50, { "ok", Tg::Color::Predefined::Green, {} });
+    statuses[13] = { "!!", Tg::Color::Predefined::Red, {} };
+    statusGrid.setItems(statuses);
+    statusGrid.show();
+
+    CHECK(QObject::connect(&statusGrid, &Tg::ItemGrid::itemPressed,
+                           &statusGrid, [&statusGrid](const int index) {
+        statusGrid.setItem(index, { "ok", Tg::Color::Predefined::Green, {} });
+    }));
+
     return app.exec();
 }
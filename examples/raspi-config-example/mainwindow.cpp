@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 
 #include <tgkey.h>
+#include <tgscreen.h>
 
 #include <widgets/tglabel.h>
 #include <widgets/tgbutton.h>
@@ -43,9 +44,14 @@ MainWindow::MainWindow(Tg::Screen *screen) : Tg::Widget(screen)
     show();
 }
 
-bool MainWindow::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool MainWindow::keyPressEvent(const Tg::KeyEvent &event)
 {
-    if (keyboardBuffer.contains('q') || keyboardBuffer == Tg::Key::escape) {
+    const bool isQ = event.key() == Tg::Key::Code::Character
+            && event.text() == QStringLiteral("q")
+            && event.modifiers().testFlag(Tg::Key::Modifier::Ctrl) == false;
+
+    if (isQ || event.key() == Tg::Key::Code::Escape) {
+        Tg::UpdateBatch batch(screen());
         auto oldModel = _listView->model();
 
         if (_currentMenuItem->hasParent()) {
@@ -76,6 +82,7 @@ void MainWindow::onIndexPressed(const QModelIndex &index)
         return;
     }
 
+    Tg::UpdateBatch batch(screen());
     auto oldModel = _listView->model();
 
     const int row = index.row();
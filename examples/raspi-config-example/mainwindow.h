@@ -23,7 +23,7 @@ signals:
     void update();
 
 protected:
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    bool keyPressEvent(const Tg::KeyEvent &event) override;
 
 private slots:
     void updateSpacerHeight();
@@ -0,0 +1,48 @@
+#include <QCoreApplication>
+
+#include <tgterminal.h>
+#include <tgscreen.h>
+#include <widgets/tgwidget.h>
+#include <widgets/tglabel.h>
+#include <widgets/tgbutton.h>
+#include <widgets/tgtextedit.h>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    Tg::RawTerminalLocker locker;
+
+    Tg::Screen screen;
+    Tg::Widget widget(&screen);
+    widget.setObjectName("widget");
+    widget.setPosition(QPoint(1, 1));
+    widget.setSize(QSize(60, 24));
+    widget.setLayoutType(Tg::Layout::Type::Column);
+    widget.setTitle(QObject::tr("Text edit (Ctrl+Z to undo, Ctrl+Y to redo)"));
+    widget.show();
+
+    Tg::Button quitButton(QObject::tr("Quit"), &widget);
+    quitButton.setObjectName("quitButton");
+    quitButton.show();
+
+    CHECK(QObject::connect(&quitButton, &Tg::Button::clicked,
+                           &app, &QCoreApplication::quit));
+
+    Tg::Label positionLabel(&widget);
+    positionLabel.show();
+
+    Tg::TextEdit textEdit(&widget);
+    textEdit.setObjectName("textEdit");
+    textEdit.setSize(QSize(58, 18));
+    textEdit.setText(QObject::tr("Type here.\nLines are not wrapped."));
+    textEdit.show();
+
+    CHECK(QObject::connect(&textEdit, &Tg::TextEdit::cursorPositionChanged,
+                           &positionLabel, [&positionLabel](const QPoint &position) {
+        positionLabel.setText(QObject::tr("Line: %1, column: %2")
+                              .arg(position.y() + 1).arg(position.x() + 1));
+    }));
+
+    return app.exec();
+}
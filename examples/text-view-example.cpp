@@ -0,0 +1,52 @@
+#include <QCoreApplication>
+
+#include <tgterminal.h>
+#include <tgscreen.h>
+#include <widgets/tgwidget.h>
+#include <widgets/tglabel.h>
+#include <widgets/tgbutton.h>
+#include <widgets/tgtextview.h>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Show the file passed on command line, or source of this example
+    const QStringList arguments = app.arguments();
+    const QString fileName = arguments.size() > 1? arguments.at(1)
+                                                 : QStringLiteral(__FILE__);
+
+    Tg::RawTerminalLocker locker;
+
+    Tg::Screen screen;
+    Tg::Widget widget(&screen);
+    widget.setObjectName("widget");
+    widget.setPosition(QPoint(1, 1));
+    widget.setSize(QSize(60, 24));
+    widget.setLayoutType(Tg::Layout::Type::Column);
+    widget.setTitle(fileName);
+    widget.show();
+
+    Tg::Button quitButton(QObject::tr("Quit"), &widget);
+    quitButton.setObjectName("quitButton");
+    quitButton.show();
+
+    CHECK(QObject::connect(&quitButton, &Tg::Button::clicked,
+                           &app, &QCoreApplication::quit));
+
+    Tg::Label linesLabel(&widget);
+    linesLabel.show();
+
+    Tg::TextView textView(&widget);
+    textView.setObjectName("textView");
+    textView.setSize(QSize(58, 18));
+    textView.setFileName(fileName);
+    textView.show();
+
+    CHECK(QObject::connect(&textView, &Tg::TextView::lineCountChanged,
+                           &linesLabel, [&linesLabel](const int lineCount) {
+        linesLabel.setText(QObject::tr("Lines: %1").arg(lineCount));
+    }));
+
+    return app.exec();
+}
@@ -4,13 +4,48 @@
 #include <widgets/tgpopup.h>
 #include <widgets/tglabel.h>
 #include <widgets/tgbutton.h>
-#include <widgets/tgscrollarea.h>
+#include <widgets/tglogview.h>
 
 #include <QObject>
 #include <QProcess>
+#include <QSharedPointer>
+#if QT_VERSION_MAJOR < 6
+#include <QTextCodec>
+#include <QTextDecoder>
+#else
+#include <QStringDecoder>
+#endif
 
 #include <QDebug>
 
+namespace {
+/*!
+ * Decodes UTF-8 which arrives in chunks, like process output. A character
+ * split between two chunks is kept until the rest of it arrives.
+ */
+class StreamDecoder
+{
+public:
+    QString decode(const QByteArray &data)
+    {
+#if QT_VERSION_MAJOR < 6
+        return _decoder->toUnicode(data);
+#else
+        return _decoder.decode(data);
+#endif
+    }
+
+private:
+#if QT_VERSION_MAJOR < 6
+    QScopedPointer<QTextDecoder> _decoder {
+        QTextCodec::codecForName("UTF-8")->makeDecoder()
+    };
+#else
+    QStringDecoder _decoder { QStringDecoder::Utf8 };
+#endif
+};
+}
+
 Tg::ActionMenuItem::ActionMenuItem(const QString &title, ListMenuItem *parent)
     : MenuItem(title, parent)
 {
@@ -72,22 +107,24 @@ void Tg::ActionMenuItem::runProcess(Tg::Widget *parent, const QString &question,
     auto *popup = new Tg::Popup(parent->size(), parent->screen());
     popup->setLayoutType(Tg::Layout::Type::Column);
 
-    auto scrollArea = new Tg::ScrollArea(popup);
-    scrollArea->setSize(QSize(popup->size().width() - 2,
-                              popup->size().height() - 4));
-
-    auto label = new Tg::Label(question, scrollArea);
-    label->setSize(QSize(scrollArea->size().width(), scrollArea->size().height()));
+    auto log = new Tg::LogView(popup);
+    log->setSize(QSize(popup->size().width() - 2,
+                       popup->size().height() - 4));
+    log->appendText(question);
 
     auto ok = new Tg::Button(QObject::tr("OK"), popup);
     auto cancel = new Tg::Button(QObject::tr("Cancel"), popup);
 
+    // Each channel needs its own decoder, chunks of both are interleaved
+    auto errorDecoder = QSharedPointer<StreamDecoder>::create();
+    auto outputDecoder = QSharedPointer<StreamDecoder>::create();
+
     auto onReadyReadError = [=]() {
-        label->setText(label->text() + "\n" + process->readAllStandardError());
+        log->appendText(errorDecoder->decode(process->readAllStandardError()));
     };
 
     auto onReadyReadOutput = [=]() {
-        label->setText(label->text() + "\n" + process->readAllStandardOutput());
+        log->appendText(outputDecoder->decode(process->readAllStandardOutput()));
     };
 
     auto onOk = [=]() {
@@ -103,7 +140,7 @@ void Tg::ActionMenuItem::runProcess(Tg::Widget *parent, const QString &question,
         }
 
         process->setProperty(isConfirmed, true);
-        label->clear();
+        log->clear();
         process->start();
     };
 
@@ -118,9 +155,9 @@ void Tg::ActionMenuItem::runProcess(Tg::Widget *parent, const QString &question,
                            process, &QProcess::deleteLater));
 
     CHECK(QObject::connect(process, &QProcess::readyReadStandardError,
-                           label, onReadyReadError));
+                           log, onReadyReadError));
     CHECK(QObject::connect(process, &QProcess::readyReadStandardOutput,
-                           label, onReadyReadOutput));
+                           log, onReadyReadOutput));
 
     popup->show();
     ok->setActiveFocus();
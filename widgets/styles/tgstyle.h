@@ -12,6 +12,10 @@ namespace Tg {
  * Defines how Widget (and all it's subclasses) draw their contents.
  *
  * Colors and characters composing borders are handled by BorderStyle.
+ *
+ * \note Widgets with local style overrides keep a resolved copy of their
+ * Style (see Widget::resolvedStyle()). After modifying a Style object which
+ * is already in use, call Screen::refreshStyle().
  */
 class Style
 {
@@ -1,15 +1,19 @@
 #include "tgscreen.h"
 #include "widgets/tgwidget.h"
-#include "widgets/tgbutton.h"
 #include "styles/tgstyle.h"
+#include "utils/tgshortcut.h"
 
 #include <tgterminal.h>
+#include <tgevent.h>
 
 #include <QCoreApplication>
 #include <QChar>
 #include <QPoint>
 #include <QRect>
 #include <QDebug>
+#include <QPair>
+
+#include <algorithm>
 
 Tg::Screen::Screen(QObject *parent, const StylePointer &style)
     : QObject(parent), _style(style)
@@ -30,11 +34,31 @@ Tg::Screen::Screen(QObject *parent, const StylePointer &style)
     CHECK(connect(&_keyboardTimer, &QTimer::timeout,
                   this, &Screen::checkKeyboard));
 
+    // Keyboard is read even with nothing to focus, so that isQuitKey() sees
+    // Ctrl+D, and Ctrl+C when RawTerminalLocker intercepts signals
+    _keyboardTimer.start();
+
+    // Checks keyboard again once pending ESC byte times out, instead of
+    // waiting for next regular keyboard poll. Coarse timers may fire up to
+    // 5% early, before the ESC byte is considered timed out
+    _escapeTimer.setInterval(_inputParser.escapeTimeout());
+    _escapeTimer.setSingleShot(true);
+    _escapeTimer.setTimerType(Qt::PreciseTimer);
+
+    CHECK(connect(&_escapeTimer, &QTimer::timeout,
+                  this, &Screen::checkKeyboard));
+
     _redrawTimer.setInterval(32);
     _redrawTimer.setSingleShot(true);
 
     CHECK(connect(&_redrawTimer, &QTimer::timeout,
                   this, &Screen::draw));
+
+    _timerWheelTimer.setInterval(TimerWheel::tickInterval);
+    _timerWheelTimer.setSingleShot(false);
+
+    CHECK(connect(&_timerWheelTimer, &QTimer::timeout,
+                  this, &Screen::advanceTimers));
 }
 
 QSize Tg::Screen::size() const
@@ -44,26 +68,146 @@ QSize Tg::Screen::size() const
 
 void Tg::Screen::registerWidget(Tg::Widget *widget)
 {
-    _widgets.append(widget);
-    widget->setStyle(_style, true);
+    // Widget::init() runs once for every class in the hierarchy of a Widget,
+    // so it is registered several times. Only the first registration adds
+    // it to the lists and connects to it
+    if (widget->_screenIndex == -1) {
+        widget->_screenIndex = _widgets.size();
+        _widgets.append(widget);
+
+        if (widget->isTopLevel()) {
+            widget->_topLevelScreenIndex = _topLevelWidgets.size();
+            _topLevelWidgets.append(widget);
+        }
+
+        widget->_focusOrder = ++_focusOrderCounter;
+        widget->setStyle(_style, true);
+
+        CHECK(connect(widget, &Widget::moveFocusToPreviousWidget,
+                      this, &Screen::moveFocusToPreviousWidget));
+        CHECK(connect(widget, &Widget::moveFocusToNextWidget,
+                      this, &Screen::moveFocusToNextWidget));
+    }
+
+    updateFocusChain(widget);
+}
+
+void Tg::Screen::deregisterWidget(Tg::Widget *widget)
+{
+    _focusChain.remove(widget);
+
+    // Entries are cleared rather than removed, to keep registration order
+    // (used by focus traversal) and back-indices of other widgets intact
+    if (widget->_screenIndex != -1) {
+        _widgets[widget->_screenIndex] = nullptr;
+        widget->_screenIndex = -1;
+        ++_removedWidgetsCount;
+    }
+
+    if (widget->_topLevelScreenIndex != -1) {
+        _topLevelWidgets[widget->_topLevelScreenIndex] = nullptr;
+        widget->_topLevelScreenIndex = -1;
+        ++_removedTopLevelWidgetsCount;
+    }
 
-    CHECK(connect(widget, &Widget::moveFocusToPreviousWidget,
-                  this, &Screen::moveFocusToPreviousWidget));
-    CHECK(connect(widget, &Widget::moveFocusToNextWidget,
-                  this, &Screen::moveFocusToNextWidget));
+    compactWidgets();
+}
+
+void Tg::Screen::updateFocusChain(Widget *widget)
+{
+    _focusChain.update(widget);
 
-    if (widget->acceptsFocus() && _activeFocusWidget.isNull()) {
+    if (_activeFocusWidget.isNull() && _focusChain.contains(widget)) {
         setActiveFocusWidget(widget);
+    }
+}
 
-        if (_keyboardTimer.isActive() == false) {
-            _keyboardTimer.start();
+Tg::Widget *Tg::Screen::focusScope() const
+{
+    if (_activeModalWidget && _activeModalWidget->isModal()) {
+        return _activeModalWidget;
+    }
+
+    return nullptr;
+}
+
+void Tg::Screen::compactWidgets()
+{
+    if (_removedWidgetsCount > (_widgets.size() / 2)) {
+        WidgetList widgets;
+        widgets.reserve(_widgets.size() - _removedWidgetsCount);
+        for (const WidgetPointer &widget : qAsConst(_widgets)) {
+            if (widget) {
+                widget->_screenIndex = widgets.size();
+                widgets.append(widget);
+            }
+        }
+
+        _widgets = widgets;
+        _removedWidgetsCount = 0;
+    }
+
+    if (_removedTopLevelWidgetsCount > (_topLevelWidgets.size() / 2)) {
+        WidgetList widgets;
+        widgets.reserve(_topLevelWidgets.size() - _removedTopLevelWidgetsCount);
+        for (const WidgetPointer &widget : qAsConst(_topLevelWidgets)) {
+            if (widget) {
+                widget->_topLevelScreenIndex = widgets.size();
+                widgets.append(widget);
+            }
         }
+
+        _topLevelWidgets = widgets;
+        _removedTopLevelWidgetsCount = 0;
     }
 }
 
-void Tg::Screen::deregisterWidget(Tg::Widget *widget)
+Tg::TimerWheel::Handle Tg::Screen::createWidgetTimer(Widget *widget,
+                                                     const int interval)
+{
+    return _timerWheel.create(widget, interval);
+}
+
+void Tg::Screen::destroyWidgetTimer(const TimerWheel::Handle handle)
+{
+    _timerWheel.destroy(handle);
+}
+
+void Tg::Screen::startWidgetTimer(const TimerWheel::Handle handle)
+{
+    _timerWheel.start(handle);
+
+    if (_timerWheelTimer.isActive() == false) {
+        _timerWheelClock.start();
+        _timerWheelTimer.start();
+    }
+}
+
+bool Tg::Screen::isWidgetTimerActive(const TimerWheel::Handle handle) const
+{
+    return _timerWheel.isActive(handle);
+}
+
+void Tg::Screen::advanceTimers()
+{
+    _timerWheel.advance(int(_timerWheelClock.restart()),
+                        [](Widget *widget, const TimerWheel::Handle handle) {
+        widget->timerExpired(handle);
+    });
+
+    if (_timerWheel.isEmpty()) {
+        _timerWheelTimer.stop();
+    }
+}
+
+void Tg::Screen::registerShortcut(Shortcut *shortcut)
+{
+    _shortcuts.insert(shortcut);
+}
+
+void Tg::Screen::deregisterShortcut(Shortcut *shortcut)
 {
-    _widgets.removeOne(widget);
+    _shortcuts.remove(shortcut);
 }
 
 void Tg::Screen::registerCurrentModalWidget(Widget *widget)
@@ -82,7 +226,7 @@ void Tg::Screen::deregisterCurrentModalWidget(Widget *widget)
 
 bool Tg::Screen::findNextModalWidget()
 {
-    for (const auto &widget : qAsConst(_widgets)) {
+    for (const auto &widget : qAsConst(_topLevelWidgets)) {
         if (findNextModalWidgetRecursive(widget)) {
             return true;
         }
@@ -102,7 +246,7 @@ bool Tg::Screen::findNextModalWidgetRecursive(Widget *widget)
         return true;
     }
 
-    const auto children = widget->childrenWidgets();
+    const auto &children = widget->childrenWidgets();
     for (const auto &child : children) {
         if (findNextModalWidgetRecursive(child)) {
             return true;
@@ -122,91 +266,74 @@ bool Tg::Screen::canDragWidgets() const
     return _canDragWidgets;
 }
 
-void Tg::Screen::scheduleRedraw(const RedrawType type, const Widget *widget)
+void Tg::Screen::beginUpdate()
 {
-    updateRedrawRegions(type, widget);
-    compressRedraws();
+    ++_updateDepth;
 }
 
-void Tg::Screen::moveFocusToPreviousWidget()
+void Tg::Screen::endUpdate()
 {
-    WidgetList widgets;
-
-    if (_activeModalWidget && _activeModalWidget->isModal()) {
-        widgets = _activeModalWidget->allFocusableChildrenWidgets();
-    } else {
-        widgets = _widgets;
+    if (_updateDepth == 0) {
+        qWarning() << "Screen::endUpdate() called without beginUpdate()";
+        return;
     }
 
-    QListIterator<WidgetPointer> iterator(_widgets);
-    iterator.findNext(_activeFocusWidget);
-
-    // Search from current focus widget backward
-    while (iterator.hasPrevious()) {
-        const WidgetPointer widget = iterator.previous();
-        if (widget && widget != _activeFocusWidget && widget->acceptsFocus()) {
-            setActiveFocusWidget(widget);
-            return;
-        }
+    --_updateDepth;
+    if (_updateDepth > 0) {
+        return;
     }
 
-    // Search from back up to current focus widget
-    iterator.toBack();
-
-    while (iterator.hasPrevious()) {
-        const WidgetPointer widget = iterator.previous();
-
-        if (widget.isNull()) {
-            continue;
-        }
+    if (_isStyleRefreshPending) {
+        refreshStyle();
+    }
 
-        if (widget == _activeFocusWidget) {
-            return;
-        } else if (widget->acceptsFocus()) {
-            setActiveFocusWidget(widget);
-            return;
-        }
+    if (_redrawRegions.isEmpty() == false || _dirtyWidgets.isEmpty() == false
+            || _dirtyLayoutWidgets.isEmpty() == false) {
+        compressRedraws();
     }
 }
 
-void Tg::Screen::moveFocusToNextWidget()
+bool Tg::Screen::isUpdating() const
 {
-    WidgetList widgets;
+    return _updateDepth > 0;
+}
 
-    if (_activeModalWidget && _activeModalWidget->isModal()) {
-        widgets = _activeModalWidget->allFocusableChildrenWidgets();
-    } else {
-        widgets = _widgets;
-    }
+void Tg::Screen::scheduleRedraw(const RedrawType type, const Widget *widget)
+{
+    updateRedrawRegions(type, widget);
+    compressRedraws();
+}
 
-    QListIterator<WidgetPointer> iterator(widgets);
-    iterator.findNext(_activeFocusWidget);
+void Tg::Screen::refreshStyle()
+{
+    if (isUpdating()) {
+        _isStyleRefreshPending = true;
+        return;
+    }
 
-    // Search from current focus widget forward
-    while (iterator.hasNext()) {
-        const WidgetPointer widget = iterator.next();
-        if (widget && widget != _activeFocusWidget && widget->acceptsFocus()) {
-            setActiveFocusWidget(widget);
-            return;
+    _isStyleRefreshPending = false;
+    for (const auto &widget : qAsConst(_widgets)) {
+        if (widget) {
+            widget->updateResolvedStyle();
         }
     }
 
-    // Search from root up to current focus widget
-    iterator.toFront();
-
-    while (iterator.hasNext()) {
-        const WidgetPointer widget = iterator.next();
+    scheduleRedraw(RedrawType::Full, nullptr);
+}
 
-        if (widget.isNull()) {
-            continue;
-        }
+void Tg::Screen::moveFocusToPreviousWidget()
+{
+    Widget *widget = _focusChain.previous(_activeFocusWidget, focusScope());
+    if (widget) {
+        setActiveFocusWidget(widget);
+    }
+}
 
-        if (widget == _activeFocusWidget) {
-            return;
-        } else if (widget->acceptsFocus()) {
-            setActiveFocusWidget(widget);
-            return;
-        }
+void Tg::Screen::moveFocusToNextWidget()
+{
+    Widget *widget = _focusChain.next(_activeFocusWidget, focusScope());
+    if (widget) {
+        setActiveFocusWidget(widget);
     }
 }
 
@@ -221,6 +348,21 @@ void Tg::Screen::setCanDragWidgets(const bool canDragWidgets)
 
 void Tg::Screen::draw()
 {
+    // Dirty widgets and redraw regions are kept, endUpdate() schedules the
+    // frame again
+    if (isUpdating()) {
+        return;
+    }
+
+    // Input has priority over rendering: apply any pending input first, so
+    // that its effects are visible in this frame already
+    if (_inputReader && _inputReader->hasEvents()) {
+        processInputReaderEvents();
+    }
+
+    layoutWidgets();
+    collectDamage();
+
     QTextStream stream(stdout);
 #if QT_VERSION_MAJOR < 6
     stream.setCodec("UTF-8");
@@ -239,7 +381,7 @@ void Tg::Screen::draw()
                     continue;
                 }
 
-                const WidgetPointer widget = Helpers::topWidget(_widgets, pixel, WidgetType::TopLevel);
+                const WidgetPointer widget = Helpers::topWidget(_topLevelWidgets, pixel, WidgetType::TopLevel);
 
                 // TODO: consider using Terminal::currentPosition() to
                 // prevent move operation if it's not needed. This could
@@ -272,110 +414,232 @@ void Tg::Screen::draw()
 
 void Tg::Screen::checkKeyboard()
 {
-    const int bufferSize = Terminal::keyboardBufferSize();
-    if (bufferSize <= 0) {
+    const QByteArray characters = Terminal::readInput();
+    if (characters.isEmpty() && _inputParser.hasPendingInput() == false) {
         return;
     }
 
-    QString characters;
-    for (int i = 0; i < bufferSize; ++i) {
-        characters.append(QChar(uint(Terminal::getChar())));
+    // Input which arrived since last poll is handled as a single frame:
+    // mouse moves and repeated navigation keys are merged together
+    const EventList events = InputParser::compressEvents(
+                _inputParser.parse(characters));
+    for (const Event &event : events) {
+        dispatchEvent(event);
+    }
+
+    if (_inputParser.hasPendingInput()) {
+        _escapeTimer.start();
     }
+}
 
-    if (characters.contains(Key::ctrlC) || characters.contains(Key::ctrlD)) {
+bool Tg::Screen::isQuitKey(const KeyEvent &event) const
+{
+    // Ctrl+C and Ctrl+D, both in legacy and in kitty keyboard encoding
+    if (event.key() != Key::Code::Character
+            || event.modifiers() != Key::Modifier::Ctrl) {
+        return false;
+    }
+
+    return event.text() == QStringLiteral("c")
+            || event.text() == QStringLiteral("d");
+}
+
+void Tg::Screen::processInputReaderEvents()
+{
+    if (_inputReader.isNull()) {
+        return;
+    }
+
+    const EventList events = _inputReader->takeEvents();
+    for (const Event &event : events) {
+        dispatchEvent(event);
+    }
+}
+
+void Tg::Screen::dispatchEvent(const Event &event)
+{
+    switch (event.type()) {
+    case Event::Type::KeyPress:
+        dispatchKeyEvent(KeyEvent(event));
+        break;
+    case Event::Type::MousePress:
+    case Event::Type::MouseRelease:
+    case Event::Type::MouseMove:
+        dispatchMouseEvent(MouseEvent(event));
+        break;
+    case Event::Type::Wheel:
+        dispatchWheelEvent(WheelEvent(event));
+        break;
+    case Event::Type::Paste:
+        dispatchPasteEvent(PasteEvent(event));
+        break;
+    case Event::Type::KeyboardProtocolReply:
+        if (_terminal && _terminal->keyboardProtocol() == false) {
+            _terminal->enableKeyboardProtocol();
+        }
+        break;
+    case Event::Type::None:
+        break;
+    }
+}
+
+void Tg::Screen::dispatchKeyEvent(const KeyEvent &event)
+{
+    if (isQuitKey(event)) {
         QCoreApplication::instance()->quit();
+        return;
     }
 
-    const int mouseEventBegin = characters.indexOf(Command::mouseEventBegin);
-    if (mouseEventBegin != -1) {
-        const int clickIndex = characters.indexOf(Command::mouseClick);
-        const int releaseIndex = characters.indexOf(Command::mouseReleaseSuffix, clickIndex);
+    if (dispatchShortcut(event)) {
+        return;
+    }
 
-        // Click & release
-        if (clickIndex != -1 && releaseIndex != -1) {
-            const int positionBeginning = clickIndex + Command::mouseClick.length();
-            const int positionLength = releaseIndex - positionBeginning;
-            const QString positionString = characters.mid(
-                        positionBeginning, positionLength);
-            const QStringList strings = positionString.split(Command::separator);
-            const QPoint click(strings.at(0).toInt(), strings.at(1).toInt());
+    if (_activeFocusWidget.isNull()) {
+        return;
+    }
 
-            if (_dragWidget.isNull() == false) {
-                handleDrag(click, false);
-                return;
-            }
+    if (event.key() == Key::Code::Tab) {
+        moveFocusToNextWidget();
+        return;
+    }
 
-            QListIterator<WidgetPointer> iterator(_widgets);
-            while (iterator.hasNext()) {
-                const WidgetPointer widget = iterator.next();
-                if (widget && widget->acceptsFocus()
-                        && widget->globalBoundingRectangle().contains(click))
-                {
-                    // Check if topWidget() and parent of _activeFocusWidget match
-                    // (to see if clicked button is visible to the user)
-                    const WidgetPointer topLevel = Helpers::topWidget(_widgets, click, WidgetType::TopLevel);
-                    if (widget->topLevelParentWidget() == topLevel) {
-                        setActiveFocusWidget(widget);
-                        auto button = qobject_cast<Button*>(widget);
-                        if (button) {
-                            button->click();
-                        }
-                        return;
-                    }
-                }
+    if (event.key() == Key::Code::Backtab) {
+        moveFocusToPreviousWidget();
+        return;
+    }
+
+    if (_activeFocusWidget->verticalArrowsMoveFocus()) {
+        if (event.key() == Key::Code::Up) {
+            for (int i = 0; i < event.count(); ++i) {
+                moveFocusToPreviousWidget();
             }
+            return;
         }
-        // Click & drag
-        else if (canDragWidgets()) {
-            // "[<0;12;5M[<32;12;5M[<32;12;5M[<32;12;6M[<32;12;6M["
-            const int coordinatesIndex = characters.indexOf(Command::separator, mouseEventBegin);
-            const int pressIndex = characters.indexOf(Command::mousePressSuffix, coordinatesIndex);
-            const int positionBeginning = coordinatesIndex + 1;
-            const int positionLength = pressIndex - positionBeginning;
-            const QString positionString = characters.mid(
-                        positionBeginning, positionLength);
-            const QStringList strings = positionString.split(Command::separator);
-            const QPoint point(strings.at(0).toInt(), strings.at(1).toInt());
-
-            handleDrag(point, (coordinatesIndex != -1 && pressIndex != -1));
+
+        if (event.key() == Key::Code::Down) {
+            for (int i = 0; i < event.count(); ++i) {
+                moveFocusToNextWidget();
+            }
             return;
         }
     }
 
-    if (_activeFocusWidget) {
-        if (const QString command(Tg::Key::tab);
-                characters.contains(command)) {
-            // Move to next input
-            moveFocusToNextWidget();
-            characters.remove(command);
+    Widget *widget = _activeFocusWidget;
+    while (widget->keyPressEvent(event) == false) {
+        widget = widget->parentWidget();
+        if (widget == nullptr) {
+            break;
         }
+    }
+}
 
-        if (_activeFocusWidget->verticalArrowsMoveFocus()) {
-            // Up Arrow
-            if (const QString command(Tg::Key::up);
-                    characters.contains(command)) {
-                moveFocusToPreviousWidget();
-                characters.remove(command);
-            }
+bool Tg::Screen::dispatchShortcut(const KeyEvent &event)
+{
+    Shortcut *shortcut = nullptr;
+    const ShortcutRegistry::Match match = _shortcuts.match(
+        KeyStroke::fromEvent(event), _activeFocusWidget, &shortcut);
 
-            // Down Arrow
-            if (const QString command(Tg::Key::down);
-                    characters.contains(command)) {
-                moveFocusToNextWidget();
-                characters.remove(command);
-            }
+    switch (match) {
+    case ShortcutRegistry::Match::NoMatch:
+        return false;
+    case ShortcutRegistry::Match::Partial:
+        return true;
+    case ShortcutRegistry::Match::Exact:
+    {
+        const QPointer<Shortcut> guard(shortcut);
+        for (int i = 0; i < event.count() && guard; ++i) {
+            emit shortcut->activated();
+        }
+        return true;
+    }
+    }
+
+    return false;
+}
+
+void Tg::Screen::dispatchMouseEvent(const MouseEvent &event)
+{
+    const QPoint point = event.position();
+
+    switch (event.type()) {
+    case Event::Type::MousePress:
+    {
+        if (event.button() != MouseButton::Left) {
+            return;
         }
 
-        Widget *widget = _activeFocusWidget;
-        while (widget->consumeKeyboardBuffer(characters) == false) {
-            widget = widget->parentWidget();
-            if (widget == nullptr) {
-                break;
+        if (canDragWidgets() && startDrag(point)) {
+            return;
+        }
+
+        QListIterator<WidgetPointer> iterator(_widgets);
+        while (iterator.hasNext()) {
+            const WidgetPointer widget = iterator.next();
+            if (widget && widget->acceptsFocus()
+                    && widget->globalClipRectangle().contains(point))
+            {
+                // Check if topWidget() and parent of _activeFocusWidget match
+                // (to see if clicked widget is visible to the user)
+                const WidgetPointer topLevel = Helpers::topWidget(_topLevelWidgets, point, WidgetType::TopLevel);
+                if (widget->topLevelParentWidget() == topLevel) {
+                    setActiveFocusWidget(widget);
+                    widget->mousePressEvent(event);
+                    return;
+                }
             }
         }
+        break;
+    }
+    case Event::Type::MouseMove:
+        if (_dragWidget && event.button() == MouseButton::Left) {
+            handleDrag(point);
+        }
+        break;
+    case Event::Type::MouseRelease:
+        if (_dragWidget) {
+            handleDrag(point);
+            endDrag();
+        }
+        break;
+    default:
+        break;
     }
 }
 
+void Tg::Screen::dispatchWheelEvent(const WheelEvent &event)
+{
+    Widget *widget = widgetAt(event.position());
+    while (widget && widget->wheelEvent(event) == false) {
+        widget = widget->parentWidget();
+    }
+}
+
+void Tg::Screen::dispatchPasteEvent(const PasteEvent &event)
+{
+    Widget *widget = _activeFocusWidget;
+    while (widget && widget->pasteEvent(event) == false) {
+        widget = widget->parentWidget();
+    }
+}
+
+Tg::Widget *Tg::Screen::widgetAt(const QPoint &point) const
+{
+    WidgetPointer widget = Helpers::topWidget(_topLevelWidgets, point, WidgetType::TopLevel);
+    while (widget) {
+        const QPoint contentsPixel(widget->mapFromGlobal(point)
+                                   - widget->contentsRectangle().topLeft());
+        const WidgetPointer child = Helpers::topWidget(
+                    widget->childrenWidgets(), contentsPixel, WidgetType::All);
+        if (child.isNull()) {
+            break;
+        }
+
+        widget = child;
+    }
+
+    return widget;
+}
+
 void Tg::Screen::setSize(const QSize &size)
 {
     if (_size != size) {
@@ -385,6 +649,96 @@ void Tg::Screen::setSize(const QSize &size)
     }
 }
 
+void Tg::Screen::scheduleWidgetRedraw(const Widget *widget)
+{
+    _dirtyWidgets.append(WidgetPointer(const_cast<Widget *>(widget)));
+    compressRedraws();
+}
+
+void Tg::Screen::scheduleRegionRedraw(const QRect &region)
+{
+    if (region.isEmpty()) {
+        return;
+    }
+
+    updateRedrawRegion(region);
+    compressRedraws();
+}
+
+void Tg::Screen::scheduleWidgetLayout(Widget *widget)
+{
+    _dirtyLayoutWidgets.append(WidgetPointer(widget));
+    compressRedraws();
+}
+
+void Tg::Screen::layoutWidgets()
+{
+    // Laying out a Widget resizes its children, which can make their layouts
+    // dirty, hence the outer loop. Within a round, parents go first
+    while (_dirtyLayoutWidgets.isEmpty() == false) {
+        QVector<QPair<int, WidgetPointer>> widgets;
+        widgets.reserve(_dirtyLayoutWidgets.size());
+        for (const WidgetPointer &widget : qAsConst(_dirtyLayoutWidgets)) {
+            if (widget.isNull()) {
+                continue;
+            }
+
+            int depth = 0;
+            for (const Widget *parent = widget->parentWidget(); parent;
+                 parent = parent->parentWidget()) {
+                ++depth;
+            }
+
+            widgets.append({ depth, widget });
+        }
+        _dirtyLayoutWidgets.clear();
+
+        std::stable_sort(widgets.begin(), widgets.end(),
+                         [](const QPair<int, WidgetPointer> &left,
+                            const QPair<int, WidgetPointer> &right) {
+            return left.first < right.first;
+        });
+
+        for (const auto &pair : qAsConst(widgets)) {
+            const WidgetPointer &widget = pair.second;
+            if (widget && widget->_isLayoutDirty) {
+                widget->doLayout();
+            }
+        }
+    }
+}
+
+void Tg::Screen::collectDamage()
+{
+    // Widgets can become dirty again while being prepared for drawing (for
+    // example when Label lays out its text), hence the outer loop
+    while (_dirtyWidgets.isEmpty() == false) {
+        const WidgetList widgets = _dirtyWidgets;
+        _dirtyWidgets.clear();
+
+        for (const WidgetPointer &widget : widgets) {
+            if (widget.isNull()) {
+                continue;
+            }
+
+            const bool previousPositionDirty = widget->_isPreviousPositionDirty;
+            const QRect previousRectangle = previousPositionDirty?
+                        widget->geometryCache().dirtyPreviousRectangle : QRect();
+            widget->_isDirty = false;
+            widget->_isPreviousPositionDirty = false;
+
+            const RedrawType type = previousPositionDirty?
+                        RedrawType::PreviousPosition : RedrawType::Partial;
+            emit widget->needsRedraw(type, widget);
+
+            if (previousPositionDirty) {
+                updateRedrawRegion(previousRectangle);
+            }
+            updateRedrawRegion(widget->globalBoundingRectangle());
+        }
+    }
+}
+
 void Tg::Screen::updateRedrawRegions(const RedrawType type,
                                      const Widget *widget)
 {
@@ -421,6 +775,10 @@ void Tg::Screen::updateRedrawRegion(const QRect &region)
 
 void Tg::Screen::compressRedraws()
 {
+    if (isUpdating()) {
+        return;
+    }
+
     if (_redrawTimer.isActive() == false) {
         _redrawTimer.start();
     }
@@ -450,64 +808,74 @@ void Tg::Screen::clearActiveFocusWidget()
     _activeFocusWidget = nullptr;
 }
 
-void Tg::Screen::handleDrag(const QPoint &point, const bool isPressActive)
+bool Tg::Screen::startDrag(const QPoint &point)
 {
-    if (isPressActive) {
-        if (_dragWidget.isNull()) {
-            const WidgetPointer widget = Helpers::topWidget(_widgets, point, WidgetType::TopLevel);
-            if (widget) {
-                const QRect rectangle = widget->globalBoundingRectangle();
-                if (widget->isTopLevel() && rectangle.contains(point)) {
-                    if (point.x() == rectangle.left()
-                            || (point.x() == rectangle.right())
-                            || point.y() == rectangle.top()
-                            || (point.y() == rectangle.bottom()))
-                    {
-                        if (point == rectangle.bottomRight()) {
-                            _dragType = DragType::Resize;
-                        } else {
-                            _dragType = DragType::Move;
-                        }
-                        _dragWidget = widget;
-                        _dragRelativePosition = widget->mapFromGlobal(point);
-                    } else {
-                        return;
-                    }
-                }
-            }
+    const WidgetPointer widget = Helpers::topWidget(_topLevelWidgets, point, WidgetType::TopLevel);
+    if (widget.isNull() || widget->isTopLevel() == false) {
+        return false;
+    }
+
+    const QRect rectangle = widget->globalBoundingRectangle();
+    if (rectangle.contains(point) == false) {
+        return false;
+    }
+
+    if (point.x() == rectangle.left()
+            || (point.x() == rectangle.right())
+            || point.y() == rectangle.top()
+            || (point.y() == rectangle.bottom()))
+    {
+        if (point == rectangle.bottomRight()) {
+            _dragType = DragType::Resize;
+        } else {
+            _dragType = DragType::Move;
         }
+        _dragWidget = widget;
+        _dragRelativePosition = widget->mapFromGlobal(point);
+        return true;
+    }
 
-        if (_dragWidget) {
-            if (_dragType == DragType::Move) {
-                // Make sure widget can't be pushed off-screen
-                QPoint position = point - _dragRelativePosition;
-                if (position.x() < 1) {
-                    position.setX(1);
-                }
-                _dragWidget->setPosition(position);
-            } else if (_dragType == DragType::Resize) {
-                const QRect rectangle = _dragWidget->globalBoundingRectangle();
-                QSize size(point.x() - rectangle.x(), point.y() - rectangle.y());
-
-                const int borders = _dragWidget->effectiveBorderWidth() * 2;
-                if (size.width() <= borders) {
-                    size.setWidth(borders + 1);
-                }
+    return false;
+}
 
-                if (size.height() <= borders) {
-                    size.setHeight(borders + 1);
-                }
+void Tg::Screen::handleDrag(const QPoint &point)
+{
+    if (_dragWidget.isNull()) {
+        return;
+    }
 
-                _dragWidget->setSize(size);
-            }
+    if (_dragType == DragType::Move) {
+        // Make sure widget can't be pushed off-screen
+        QPoint position = point - _dragRelativePosition;
+        if (position.x() < 1) {
+            position.setX(1);
         }
-    } else {
-        _dragRelativePosition = QPoint();
-        _dragWidget.clear();
-        _dragType = DragType::Unknown;
+        _dragWidget->setPosition(position);
+    } else if (_dragType == DragType::Resize) {
+        const QRect rectangle = _dragWidget->globalBoundingRectangle();
+        // Bottom-right corner of the Widget follows the mouse cursor
+        QSize size(point.x() - rectangle.x() + 1, point.y() - rectangle.y() + 1);
+
+        const int borders = _dragWidget->effectiveBorderWidth() * 2;
+        if (size.width() <= borders) {
+            size.setWidth(borders + 1);
+        }
+
+        if (size.height() <= borders) {
+            size.setHeight(borders + 1);
+        }
+
+        _dragWidget->setSize(size);
     }
 }
 
+void Tg::Screen::endDrag()
+{
+    _dragRelativePosition = QPoint();
+    _dragWidget.clear();
+    _dragType = DragType::Unknown;
+}
+
 bool Tg::Screen::mouseTracking() const
 {
     return _terminal->mouseTracking();
@@ -527,3 +895,69 @@ void Tg::Screen::setMouseTracking(const bool enable)
 
     emit mouseTrackingChanged();
 }
+
+int Tg::Screen::escapeTimeout() const
+{
+    return _inputParser.escapeTimeout();
+}
+
+void Tg::Screen::setEscapeTimeout(const int escapeTimeout)
+{
+    if (_inputParser.escapeTimeout() == escapeTimeout) {
+        return;
+    }
+
+    _inputParser.setEscapeTimeout(escapeTimeout);
+    _escapeTimer.setInterval(_inputParser.escapeTimeout());
+    if (_inputReader) {
+        _inputReader->setEscapeTimeout(_inputParser.escapeTimeout());
+    }
+
+    emit escapeTimeoutChanged(_inputParser.escapeTimeout());
+}
+
+bool Tg::Screen::threadedInput() const
+{
+    return _inputReader.isNull() == false;
+}
+
+void Tg::Screen::setThreadedInput(const bool enable)
+{
+    if (threadedInput() == enable) {
+        return;
+    }
+
+    if (enable) {
+        _keyboardTimer.stop();
+        _escapeTimer.stop();
+
+        // From now on all input is decoded by the reader thread, including
+        // sequences which have only partially arrived
+        _inputReader = new InputReader(this);
+        _inputReader->setEscapeTimeout(_inputParser.escapeTimeout());
+        _inputReader->setPendingInput(_inputParser.takePendingInput());
+        CHECK(connect(_inputReader, &InputReader::eventsAvailable,
+                      this, &Screen::processInputReaderEvents));
+        _inputReader->start();
+    } else {
+        _inputReader->stop();
+        // Events decoded before the thread stopped must not be lost
+        processInputReaderEvents();
+
+        const EventList events = _inputParser.parse(
+                    _inputReader->takePendingInput());
+        delete _inputReader;
+
+        for (const Event &event : events) {
+            dispatchEvent(event);
+        }
+
+        if (_inputParser.hasPendingInput()) {
+            _escapeTimer.start();
+        }
+
+        _keyboardTimer.start();
+    }
+
+    emit threadedInputChanged(enable);
+}
@@ -6,8 +6,15 @@
 #include <QSize>
 #include <QRect>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include "utils/tghelpers.h"
+#include "utils/tgshortcutregistry.h"
+#include "utils/tgfocuschain.h"
+#include "utils/tgtimerwheel.h"
+
+#include <tginputparser.h>
+#include <tginputreader.h>
 
 /*!
  * All Terminal GUI classes (both core and widgets) are defined within the Tg
@@ -56,7 +63,31 @@ class Screen : public QObject
      */
     Q_PROPERTY(bool mouseTracking READ mouseTracking WRITE setMouseTracking NOTIFY mouseTrackingChanged)
 
+    /*!
+     * Time (in milliseconds) to wait for the rest of an escape sequence before
+     * a lone ESC byte is reported as Escape key press.
+     *
+     * Lower values make Escape key more responsive, higher values are more
+     * reliable over slow connections. This setting has no effect on terminals
+     * supporting kitty keyboard protocol, where Escape key is always reported
+     * immediately.
+     *
+     * \sa InputParser::setEscapeTimeout
+     */
+    Q_PROPERTY(int escapeTimeout READ escapeTimeout WRITE setEscapeTimeout NOTIFY escapeTimeoutChanged)
+
+    /*!
+     * When `true`, terminal input is read and decoded by a separate thread
+     * (see InputReader) instead of being polled from the GUI thread every
+     * 100 ms. Input is then timestamped when it arrives, even if GUI thread is
+     * busy, and pending input is always handled before the next redraw.
+     *
+     * Default is `false`.
+     */
+    Q_PROPERTY(bool threadedInput READ threadedInput WRITE setThreadedInput NOTIFY threadedInputChanged)
+
     friend class Widget;
+    friend class Shortcut;
 
 public:
     /*!
@@ -86,6 +117,38 @@ public:
     bool mouseTracking() const;
     void setMouseTracking(const bool enable);
 
+    int escapeTimeout() const;
+    void setEscapeTimeout(const int escapeTimeout);
+
+    bool threadedInput() const;
+    void setThreadedInput(const bool enable);
+
+    /*!
+     * Starts a batch of updates. Until matching endUpdate() is called, Screen
+     * does not lay out, collect damage, refresh styles nor draw anything:
+     * all changes made in the meantime are applied in a single pass when the
+     * batch ends.
+     *
+     * Calls can be nested, the batch ends with the outermost endUpdate().
+     * Prefer using UpdateBatch, which calls these methods automatically.
+     *
+     * \sa UpdateBatch
+     */
+    void beginUpdate();
+
+    /*!
+     * Ends a batch of updates started with beginUpdate(). When the outermost
+     * batch ends, pending work is applied and the next frame is scheduled.
+     */
+    void endUpdate();
+
+    /*!
+     * Returns `true` while a batch of updates is in progress.
+     *
+     * \sa beginUpdate
+     */
+    bool isUpdating() const;
+
 public slots:
     /*!
      * Schedules a redraw of \a widget using \a type.
@@ -117,6 +180,16 @@ public slots:
 
     void setCanDragWidgets(const bool canDragWidgets);
 
+    /*!
+     * Recomputes Widget::resolvedStyle() of all widgets and redraws the
+     * Screen.
+     *
+     * Widgets take a snapshot of their Style, so changes made to a Style
+     * object in place (for example, when switching a color theme) become
+     * visible only after this method is called.
+     */
+    void refreshStyle();
+
 signals:
     /*!
      * Emitted when Screen's \a size is modified.
@@ -127,9 +200,15 @@ signals:
 
     void mouseTrackingChanged() const;
 
+    void escapeTimeoutChanged(const int escapeTimeout) const;
+
+    void threadedInputChanged(const bool threadedInput) const;
+
 private slots:
     void draw();
     void checkKeyboard();
+    void processInputReaderEvents();
+    void advanceTimers();
     void setSize(const QSize &size);
 
 private:
@@ -149,12 +228,92 @@ private:
     void registerWidget(Widget *widget);
     void deregisterWidget(Widget *widget);
 
+    /*!
+     * Adds \a widget to the FocusChain, or removes it from there, depending
+     * on Widget::acceptsFocus() and Widget::visible(). If no Widget has focus
+     * yet, \a widget receives it once it is in the chain.
+     */
+    void updateFocusChain(Widget *widget);
+
+    /*!
+     * Returns the modal Widget to which focus navigation is limited, or
+     * `nullptr` if there is none.
+     */
+    Widget *focusScope() const;
+
+    /*!
+     * Drops entries of deregistered widgets from widget lists, once they make
+     * up more than half of a list. This keeps deregisterWidget() O(1)
+     * (amortized) while preserving the order of remaining widgets.
+     */
+    void compactWidgets();
+
+    /*!
+     * Adds \a shortcut to the ShortcutRegistry of this Screen.
+     *
+     * \sa dispatchShortcut
+     */
+    void registerShortcut(Shortcut *shortcut);
+    void deregisterShortcut(Shortcut *shortcut);
+
+    /*!
+     * Creates a timer in the TimerWheel of this Screen, owned by \a widget.
+     * When it expires, Widget::timerExpired() is called.
+     *
+     * \sa startWidgetTimer
+     */
+    TimerWheel::Handle createWidgetTimer(Widget *widget, const int interval);
+    void destroyWidgetTimer(const TimerWheel::Handle handle);
+
+    /*!
+     * (Re)starts timer \a handle. The clock driving the TimerWheel runs only
+     * while at least one timer is active.
+     */
+    void startWidgetTimer(const TimerWheel::Handle handle);
+    bool isWidgetTimerActive(const TimerWheel::Handle handle) const;
+
     void registerCurrentModalWidget(Widget *widget);
     void deregisterCurrentModalWidget(Widget *widget);
 
     bool findNextModalWidget();
     bool findNextModalWidgetRecursive(Widget *widget);
 
+    /*!
+     * Adds \a widget to the list of widgets to redraw in next frame. Called
+     * by Widget once per frame, when it becomes dirty.
+     *
+     * \sa collectDamage
+     */
+    void scheduleWidgetRedraw(const Widget *widget);
+
+    /*!
+     * Adds \a region (in Screen coordinates) to the area redrawn in next
+     * frame, without marking any Widget as dirty.
+     *
+     * \sa Widget::scheduleRectangleRedraw
+     */
+    void scheduleRegionRedraw(const QRect &region);
+
+    /*!
+     * Adds \a widget to the list of widgets to lay out before next frame.
+     * Called by Widget::scheduleLayout(), once per frame.
+     *
+     * \sa layoutWidgets
+     */
+    void scheduleWidgetLayout(Widget *widget);
+
+    /*!
+     * Lays out all widgets with dirty layout, parents first. Runs right
+     * before collectDamage(), so that each Widget is laid out at most once
+     * per frame, no matter how many times its size or children changed.
+     */
+    void layoutWidgets();
+
+    /*!
+     * Turns all dirty widgets into redraw regions, right before drawing.
+     */
+    void collectDamage();
+
     void updateRedrawRegions(const RedrawType type, const Widget *widget);
     void updateRedrawRegion(const QRect &region);
 
@@ -167,22 +326,103 @@ private:
     void setActiveFocusWidget(const WidgetPointer &widget);
     void clearActiveFocusWidget();
 
-    void handleDrag(const QPoint &point, const bool isPressActive);
+    bool isQuitKey(const KeyEvent &event) const;
+    void dispatchEvent(const Event &event);
+    void dispatchKeyEvent(const KeyEvent &event);
+
+    /*!
+     * Matches \a event against registered shortcuts. Returns `true` if the
+     * key press was consumed (it either activated a Shortcut or continued
+     * a multi-key chord) and should not be passed to widgets.
+     */
+    bool dispatchShortcut(const KeyEvent &event);
+    void dispatchMouseEvent(const MouseEvent &event);
+    void dispatchWheelEvent(const WheelEvent &event);
+    void dispatchPasteEvent(const PasteEvent &event);
 
+    /*!
+     * Returns the deepest visible Widget at \a point (in Screen coordinates),
+     * or `nullptr` if there is no Widget there.
+     */
+    Widget *widgetAt(const QPoint &point) const;
+
+    bool startDrag(const QPoint &point);
+    void handleDrag(const QPoint &point);
+    void endDrag();
+
+    InputParser _inputParser;
+    QPointer<InputReader> _inputReader;
     QTimer _keyboardTimer;
+    QTimer _escapeTimer;
     QTimer _redrawTimer;
+    QTimer _timerWheelTimer;
+    QElapsedTimer _timerWheelClock;
     QVector<QRect> _redrawRegions;
+    WidgetList _dirtyWidgets;
+    WidgetList _dirtyLayoutWidgets;
     QSize _size;
 
+    // All registered widgets (in registration order) and only the top-level
+    // ones. Deregistered widgets leave empty entries, see compactWidgets()
     WidgetList _widgets;
+    WidgetList _topLevelWidgets;
+    int _removedWidgetsCount = 0;
+    int _removedTopLevelWidgetsCount = 0;
+    FocusChain _focusChain;
+    quint64 _focusOrderCounter = 0;
+    ShortcutRegistry _shortcuts;
+    TimerWheel _timerWheel;
     WidgetPointer _activeFocusWidget;
     WidgetPointer _activeModalWidget;
     StylePointer _style;
     QPointer<Terminal> _terminal;
 
+    int _updateDepth = 0;
+    bool _isStyleRefreshPending = false;
+
     bool _canDragWidgets = true;
     DragType _dragType = DragType::Unknown;
     WidgetPointer _dragWidget;
     QPoint _dragRelativePosition;
 };
+
+/*!
+ * \brief Batches all updates made to a Screen within a scope.
+ *
+ * Calls Screen::beginUpdate() when constructed and Screen::endUpdate() when
+ * destroyed. This is similar to QSignalBlocker, but signals are still
+ * delivered - only the layout, style refresh and drawing are postponed until
+ * the end of the scope, and then done once.
+ *
+ * \code
+ * void MainWindow::showMenu(const QStringList &items)
+ * {
+ *     Tg::UpdateBatch batch(screen());
+ *     _listView->setModel(new QStringListModel(items, _listView));
+ *     _title->setText(tr("Menu"));
+ * } // Screen is laid out and redrawn once, here
+ * \endcode
+ */
+class UpdateBatch
+{
+public:
+    explicit UpdateBatch(Screen *screen) : _screen(screen)
+    {
+        if (_screen) {
+            _screen->beginUpdate();
+        }
+    }
+
+    ~UpdateBatch()
+    {
+        if (_screen) {
+            _screen->endUpdate();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(UpdateBatch)
+
+    QPointer<Screen> _screen;
+};
 }
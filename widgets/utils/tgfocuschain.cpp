@@ -0,0 +1,165 @@
+#include "tgfocuschain.h"
+#include "widgets/tgwidget.h"
+
+void Tg::FocusChain::update(Widget *widget)
+{
+    if (widget->acceptsFocus() == false || widget->visible() == false) {
+        remove(widget);
+        return;
+    }
+
+    if (contains(widget)) {
+        return;
+    }
+
+    const auto it = _order.insert(widget->_focusOrder, widget);
+
+    Node node;
+    if (it != _order.begin()) {
+        auto previousIt = it;
+        --previousIt;
+        node.previous = previousIt.value();
+        _nodes[node.previous].next = widget;
+    }
+
+    auto nextIt = it;
+    ++nextIt;
+    if (nextIt != _order.end()) {
+        node.next = nextIt.value();
+        _nodes[node.next].previous = widget;
+    }
+
+    _nodes.insert(widget, node);
+}
+
+void Tg::FocusChain::remove(Widget *widget)
+{
+    if (contains(widget) == false) {
+        return;
+    }
+
+    const Node node = _nodes.take(widget);
+    if (node.previous) {
+        _nodes[node.previous].next = node.next;
+    }
+
+    if (node.next) {
+        _nodes[node.next].previous = node.previous;
+    }
+
+    _order.remove(widget->_focusOrder);
+}
+
+bool Tg::FocusChain::contains(const Widget *widget) const
+{
+    return _nodes.contains(widget);
+}
+
+Tg::Widget *Tg::FocusChain::next(const Widget *current,
+                                 const Widget *scope) const
+{
+    Widget *widget = contains(current)? step(current, true) : nullptr;
+    bool hasWrapped = false;
+
+    while (true) {
+        if (widget == nullptr) {
+            if (hasWrapped) {
+                return nullptr;
+            }
+
+            hasWrapped = true;
+            widget = first(scope);
+            continue;
+        }
+
+        if (widget == current) {
+            return nullptr;
+        }
+
+        if (isInScope(widget, scope)) {
+            return widget;
+        }
+
+        widget = step(widget, true);
+    }
+}
+
+Tg::Widget *Tg::FocusChain::previous(const Widget *current,
+                                     const Widget *scope) const
+{
+    Widget *widget = contains(current)? step(current, false) : nullptr;
+    bool hasWrapped = false;
+
+    while (true) {
+        if (widget == nullptr) {
+            if (hasWrapped) {
+                return nullptr;
+            }
+
+            hasWrapped = true;
+            widget = last();
+            continue;
+        }
+
+        if (widget == current) {
+            return nullptr;
+        }
+
+        if (isInScope(widget, scope)) {
+            return widget;
+        }
+
+        widget = step(widget, false);
+    }
+}
+
+Tg::Widget *Tg::FocusChain::step(const Widget *widget, const bool forward) const
+{
+    const Node node = _nodes.value(widget);
+    return forward? node.next : node.previous;
+}
+
+Tg::Widget *Tg::FocusChain::first(const Widget *scope) const
+{
+    if (_order.isEmpty()) {
+        return nullptr;
+    }
+
+    if (scope == nullptr) {
+        return _order.first();
+    }
+
+    // Children are always registered after their parent, so descendants of
+    // scope can't be found before it
+    const auto it = _order.lowerBound(scope->_focusOrder);
+    if (it == _order.end()) {
+        return nullptr;
+    }
+
+    return it.value();
+}
+
+Tg::Widget *Tg::FocusChain::last() const
+{
+    if (_order.isEmpty()) {
+        return nullptr;
+    }
+
+    return _order.last();
+}
+
+bool Tg::FocusChain::isInScope(const Widget *widget, const Widget *scope) const
+{
+    if (scope == nullptr) {
+        return true;
+    }
+
+    for (const Widget *parent = widget->parentWidget(); parent;
+         parent = parent->parentWidget()) {
+        if (parent == scope) {
+            return true;
+        }
+    }
+
+    return false;
+}
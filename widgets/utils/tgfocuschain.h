@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QMap>
+#include <QHash>
+
+namespace Tg {
+class Widget;
+
+/*!
+ * \brief Ordered list of all visible widgets which accept keyboard focus.
+ *
+ * Widgets are kept in the order in which they were registered with Screen
+ * (which is the order of Tab navigation), in a doubly linked list. Moving
+ * to the next or previous Widget is O(1), adding or removing a Widget (when
+ * it is created, destroyed, shown, hidden or its Widget::acceptsFocus()
+ * changes) is O(log n).
+ *
+ * Navigation can be limited to a scope - descendants of a modal Widget.
+ * Widgets outside of the scope are skipped, which is cheap as long as
+ * descendants of the modal Widget were created one after another.
+ *
+ * This class is internal, it is used by Screen.
+ */
+class FocusChain
+{
+public:
+    /*!
+     * Adds \a widget to the chain if it is visible and accepts focus, or
+     * removes it from the chain otherwise.
+     */
+    void update(Widget *widget);
+
+    /*!
+     * Removes \a widget from the chain.
+     */
+    void remove(Widget *widget);
+
+    /*!
+     * Returns `true` if \a widget is part of the chain.
+     */
+    bool contains(const Widget *widget) const;
+
+    /*!
+     * Returns the Widget following \a current within \a scope (or anywhere,
+     * when \a scope is `nullptr`), wrapping around at the end. If \a current
+     * is not part of the chain, first Widget of the \a scope is returned.
+     *
+     * Returns `nullptr` when there is no other Widget to move focus to.
+     */
+    Widget *next(const Widget *current, const Widget *scope) const;
+
+    /*!
+     * Returns the Widget preceding \a current within \a scope, wrapping
+     * around at the beginning.
+     *
+     * \sa next
+     */
+    Widget *previous(const Widget *current, const Widget *scope) const;
+
+private:
+    struct Node {
+        Widget *previous = nullptr;
+        Widget *next = nullptr;
+    };
+
+    Widget *step(const Widget *widget, const bool forward) const;
+    Widget *first(const Widget *scope) const;
+    Widget *last() const;
+    bool isInScope(const Widget *widget, const Widget *scope) const;
+
+    QMap<quint64, Widget *> _order;
+    QHash<const Widget *, Node> _nodes;
+};
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <QVector>
+
+#include <algorithm>
+#include <utility>
+
+namespace Tg {
+/*!
+ * \brief Sequence with cheap insertion and removal around a moving position.
+ *
+ * GapBuffer keeps its items in one array with a gap of unused slots in the
+ * middle. Insertion and removal happen at the gap, so they take O(1) time
+ * when consecutive edits are close to each other (as is the case when
+ * typing), and the gap only has to be moved by the distance between edits.
+ * Access by index is O(1).
+ *
+ * This class is internal, it is used by TextEdit to keep lines of text.
+ */
+template<typename T>
+class GapBuffer
+{
+public:
+    int size() const
+    {
+        return int(_data.size()) - gapSize();
+    }
+
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    const T &at(const int index) const
+    {
+        return _data.at(physicalIndex(index));
+    }
+
+    T &operator[](const int index)
+    {
+        return _data[physicalIndex(index)];
+    }
+
+    /*!
+     * Inserts \a value so that it ends up at \a index.
+     */
+    void insert(const int index, const T &value);
+
+    /*!
+     * Removes \a count items, starting at \a index.
+     */
+    void remove(const int index, const int count = 1);
+
+    void clear()
+    {
+        _data.clear();
+        _gapStart = 0;
+        _gapEnd = 0;
+    }
+
+private:
+    int gapSize() const
+    {
+        return _gapEnd - _gapStart;
+    }
+
+    int physicalIndex(const int index) const
+    {
+        return (index < _gapStart)? index : index + gapSize();
+    }
+
+    void moveGap(const int index);
+    void grow();
+
+    static constexpr int minimumCapacity = 16;
+
+    QVector<T> _data;
+    int _gapStart = 0;
+    int _gapEnd = 0;
+};
+
+template<typename T>
+void GapBuffer<T>::insert(const int index, const T &value)
+{
+    if (gapSize() == 0) {
+        grow();
+    }
+
+    moveGap(index);
+    _data[_gapStart] = value;
+    ++_gapStart;
+}
+
+template<typename T>
+void GapBuffer<T>::remove(const int index, const int count)
+{
+    moveGap(index);
+    for (int i = 0; i < count; ++i) {
+        // Release the memory held by removed item
+        _data[_gapEnd] = T();
+        ++_gapEnd;
+    }
+}
+
+template<typename T>
+void GapBuffer<T>::moveGap(const int index)
+{
+    if (index < _gapStart) {
+        // Items before the gap are moved behind it
+        const int count = _gapStart - index;
+        for (int i = 1; i <= count; ++i) {
+            _data[_gapEnd - i] = std::move(_data[_gapStart - i]);
+        }
+        _gapStart -= count;
+        _gapEnd -= count;
+    } else if (index > _gapStart) {
+        // Items after the gap are moved in front of it
+        const int count = index - _gapStart;
+        for (int i = 0; i < count; ++i) {
+            _data[_gapStart + i] = std::move(_data[_gapEnd + i]);
+        }
+        _gapStart += count;
+        _gapEnd += count;
+    }
+}
+
+template<typename T>
+void GapBuffer<T>::grow()
+{
+    const int oldCapacity = int(_data.size());
+    const int capacity = std::max(minimumCapacity, oldCapacity * 2);
+    const int tailSize = oldCapacity - _gapEnd;
+
+    QVector<T> data(capacity);
+    for (int i = 0; i < _gapStart; ++i) {
+        data[i] = std::move(_data[i]);
+    }
+
+    const int newGapEnd = capacity - tailSize;
+    for (int i = 0; i < tailSize; ++i) {
+        data[newGapEnd + i] = std::move(_data[_gapEnd + i]);
+    }
+
+    _data = data;
+    _gapEnd = newGapEnd;
+}
+}
@@ -8,30 +8,21 @@ Tg::WidgetPointer Tg::Helpers::topWidget(const Tg::WidgetList &widgets,
                                          const QPoint &pixel,
                                          const Tg::WidgetType type)
 {
-    const auto comparison = [](const WidgetPointer &left, const WidgetPointer &right) {
-        return left->z() < right->z();
-    };
-
-    // TODO: sort by Z value...
-    WidgetList affectedWidgets;
+    // Highest Z value wins. With equal Z, the widget added last is on top.
+    // Widget::childrenWidgets() is already sorted by Z, but Screen's list of
+    // top-level widgets is not, so all widgets have to be checked
+    WidgetPointer result;
     for (const WidgetPointer &widget : widgets) {
         if (widget && widget->visible()) {
             if ((type == WidgetType::TopLevel && widget->isTopLevel())
                     || type == WidgetType::All) {
-                if (widget->boundingRectangle().contains(pixel)) {
-                    affectedWidgets.append(widget);
-                    // Keep the list sorted - highest Z value is last
-                    std::sort(affectedWidgets.begin(), affectedWidgets.end(), comparison);
+                if (widget->boundingRectangle().contains(pixel)
+                        && (result.isNull() || widget->z() >= result->z())) {
+                    result = widget;
                 }
             }
         }
     }
 
-    // TODO: properly handle Z value...
-    if (affectedWidgets.isEmpty()) {
-        return nullptr;
-    } else {
-        // The list is sorted, so we can safely take the last element:
-        return affectedWidgets.last();
-    }
+    return result;
 }
@@ -0,0 +1,42 @@
+#include "tglinecells.h"
+#include "tgtext.h"
+
+#include <tgunicode.h>
+
+bool Tg::LineCells::contains(const int line) const
+{
+    return _line == line;
+}
+
+void Tg::LineCells::setLine(const int line, const QString &text)
+{
+    _line = line;
+    _text = text;
+    _cells.clear();
+    Text::layoutCells(_text, 0, int(_text.size()), &_cells);
+}
+
+void Tg::LineCells::clear()
+{
+    _line = -1;
+}
+
+int Tg::LineCells::width() const
+{
+    return int(_cells.size());
+}
+
+bool Tg::LineCells::appendCell(const int column, QString *result) const
+{
+    if (column < 0 || column >= _cells.size()) {
+        return false;
+    }
+
+    // Nothing is printed in a column covered by a wide character
+    const int position = _cells.at(column);
+    if (position != -1) {
+        const int end = Unicode::nextGraphemeBoundary(_text, position);
+        result->append(_text.constData() + position, end - position);
+    }
+    return true;
+}
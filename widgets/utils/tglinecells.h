@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+namespace Tg {
+/*!
+ * \brief A single line of text, laid out into terminal cells.
+ *
+ * Widgets which draw text cell by cell keep the line drawn last in a
+ * LineCells object. Looking up what to print in a cell is then O(1), instead
+ * of walking the line from its start for every cell.
+ *
+ * This class is internal, it is used by ListView, LogView, TextView and
+ * TextEdit.
+ */
+class LineCells
+{
+public:
+    /*!
+     * Returns `true` if line number \a line is the one laid out.
+     */
+    bool contains(const int line) const;
+
+    /*!
+     * Lays out \a text as line number \a line, see Text::layoutCells().
+     */
+    void setLine(const int line, const QString &text);
+
+    /*!
+     * Forgets the laid out line. Call it when text of the line may change.
+     */
+    void clear();
+
+    /*!
+     * Returns number of cells taken by the line.
+     */
+    int width() const;
+
+    /*!
+     * Appends text drawn in cell at \a column to \a result. Nothing is
+     * appended for a cell covered by a wide character on its left.
+     *
+     * Returns `false` if \a column is outside of the line.
+     */
+    bool appendCell(const int column, QString *result) const;
+
+private:
+    int _line = -1;
+    QString _text;
+    QVector<int> _cells;
+};
+}
@@ -0,0 +1,102 @@
+#include "tglineindexer.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+Tg::LineIndexer::LineIndexer(const uchar *data, const qint64 size,
+                             const int tabWidth, QObject *parent)
+    : QThread(parent), _data(data), _size(size), _tabWidth(tabWidth)
+{
+}
+
+Tg::LineIndexer::~LineIndexer()
+{
+    stop();
+}
+
+QVector<qint64> Tg::LineIndexer::takeLineStarts()
+{
+    QMutexLocker locker(&_mutex);
+    const QVector<qint64> result = _lineStarts;
+    _lineStarts.clear();
+    return result;
+}
+
+int Tg::LineIndexer::longestLine() const
+{
+    return _longestLine;
+}
+
+void Tg::LineIndexer::stop()
+{
+    requestInterruption();
+    wait();
+}
+
+void Tg::LineIndexer::run()
+{
+    QVector<qint64> lineStarts;
+    qint64 lineStart = 0;
+    qint64 position = 0;
+    qint64 chunk = firstChunkSize;
+    int longest = 0;
+
+    while (position < _size && isInterruptionRequested() == false) {
+        const qint64 chunkEnd = std::min(_size, position + chunk);
+        chunk = chunkSize;
+
+        while (position < chunkEnd) {
+            const void *found = std::memchr(_data + position, '\n',
+                                            size_t(chunkEnd - position));
+            if (found == nullptr) {
+                position = chunkEnd;
+                break;
+            }
+
+            const qint64 lineBreak = static_cast<const uchar *>(found) - _data;
+            longest = std::max(longest, lineWidth(lineStart, lineBreak));
+            lineStart = lineBreak + 1;
+            lineStarts.append(lineStart);
+            position = lineStart;
+        }
+
+        _longestLine = longest;
+        publish(&lineStarts);
+    }
+
+    if (isInterruptionRequested()) {
+        return;
+    }
+
+    // Last line is not terminated by a line break
+    if (lineStart < _size) {
+        _longestLine = std::max(longest, lineWidth(lineStart, _size));
+        lineStarts.append(_size + 1);
+        publish(&lineStarts);
+    }
+}
+
+int Tg::LineIndexer::lineWidth(const qint64 start, const qint64 end) const
+{
+    const qint64 tabs = std::count(_data + start, _data + end, uchar('\t'));
+    const qint64 width = (end - start) + (tabs * (_tabWidth - 1));
+    return int(std::min(width, qint64(std::numeric_limits<int>::max())));
+}
+
+void Tg::LineIndexer::publish(QVector<qint64> *lineStarts)
+{
+    if (lineStarts->isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        _lineStarts.append(*lineStarts);
+    }
+
+    lineStarts->clear();
+    emit linesIndexed();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QVector>
+
+#include <atomic>
+
+namespace Tg {
+/*!
+ * \brief Finds where lines start in a block of memory, in a separate thread.
+ *
+ * LineIndexer scans \a data (usually a memory-mapped file) for line breaks
+ * and collects offsets at which lines start. Offsets are published in
+ * batches: the first one is small, so that the beginning of a large file
+ * can be shown right away, the following ones are bigger. linesIndexed() is
+ * emitted whenever a new batch is waiting to be taken with takeLineStarts().
+ *
+ * Offset of the first line (`0`) is not reported. When whole data is
+ * scanned and it does not end with a line break, `size + 1` is reported as
+ * start of a line following the last one, so that every line ends one byte
+ * before the next one starts.
+ *
+ * \warning \a data must stay valid until the thread is stopped.
+ *
+ * This class is internal, it is used by TextView.
+ */
+class LineIndexer : public QThread
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * Constructs LineIndexer of \a size bytes of \a data as a child of
+     * \a parent. Tabs are expected to be expanded to stops every
+     * \a tabWidth columns. The thread is not started, call start() to begin
+     * indexing.
+     */
+    LineIndexer(const uchar *data, const qint64 size, const int tabWidth,
+                QObject *parent = nullptr);
+
+    /*!
+     * Stops the thread.
+     */
+    ~LineIndexer();
+
+    /*!
+     * Removes line offsets found so far from the indexer and returns them,
+     * in ascending order.
+     */
+    QVector<qint64> takeLineStarts();
+
+    /*!
+     * Returns width (in columns) of the longest line found so far. It is an
+     * upper bound: every byte is counted as one column, except tabs which
+     * are counted as tabWidth columns.
+     */
+    int longestLine() const;
+
+    /*!
+     * Asks the thread to stop and waits until it does.
+     */
+    void stop();
+
+signals:
+    /*!
+     * Emitted (from the indexer thread) after a batch of line offsets has
+     * been found.
+     */
+    void linesIndexed() const;
+
+protected:
+    void run() override;
+
+private:
+    void publish(QVector<qint64> *lineStarts);
+    int lineWidth(const qint64 start, const qint64 end) const;
+
+    /*!
+     * Size (in bytes) of the first and of all following chunks of data
+     * scanned before a batch is published.
+     */
+    static const qint64 firstChunkSize = 64 * 1024;
+    static const qint64 chunkSize = 4 * 1024 * 1024;
+
+    const uchar *_data = nullptr;
+    const qint64 _size = 0;
+    const int _tabWidth = 1;
+
+    QMutex _mutex;
+    QVector<qint64> _lineStarts;
+    std::atomic<int> _longestLine = { 0 };
+};
+}
@@ -0,0 +1,135 @@
+#include "tgshortcut.h"
+#include "tgscreen.h"
+#include "widgets/tgwidget.h"
+
+Tg::Shortcut::Shortcut(const KeySequence &sequence, Widget *parent,
+                       const Context context)
+    : QObject(parent),
+      _screen(parent->screen()),
+      _parentWidget(parent),
+      _keySequence(sequence),
+      _context(context)
+{
+    init();
+}
+
+Tg::Shortcut::Shortcut(const KeySequence &sequence, Screen *screen)
+    : QObject(screen),
+      _screen(screen),
+      _keySequence(sequence),
+      _context(Context::Application)
+{
+    init();
+}
+
+Tg::Shortcut::~Shortcut()
+{
+    if (_screen) {
+        _screen->deregisterShortcut(this);
+    }
+}
+
+Tg::KeySequence Tg::Shortcut::keySequence() const
+{
+    return _keySequence;
+}
+
+void Tg::Shortcut::setKeySequence(const KeySequence &keySequence)
+{
+    if (_keySequence == keySequence) {
+        return;
+    }
+
+    if (_screen) {
+        _screen->deregisterShortcut(this);
+    }
+
+    _keySequence = keySequence;
+
+    if (_screen) {
+        _screen->registerShortcut(this);
+    }
+
+    emit keySequenceChanged(_keySequence);
+}
+
+Tg::Shortcut::Context Tg::Shortcut::context() const
+{
+    return _context;
+}
+
+void Tg::Shortcut::setContext(const Context context)
+{
+    if (_context == context) {
+        return;
+    }
+
+    // Registry counts shortcuts by their context, see ShortcutRegistry
+    if (_screen) {
+        _screen->deregisterShortcut(this);
+    }
+
+    _context = context;
+
+    if (_screen) {
+        _screen->registerShortcut(this);
+    }
+
+    emit contextChanged(_context);
+}
+
+bool Tg::Shortcut::enabled() const
+{
+    return _enabled;
+}
+
+void Tg::Shortcut::setEnabled(const bool enabled)
+{
+    if (_enabled == enabled) {
+        return;
+    }
+
+    if (_screen) {
+        _screen->deregisterShortcut(this);
+    }
+
+    _enabled = enabled;
+
+    if (_screen) {
+        _screen->registerShortcut(this);
+    }
+
+    emit enabledChanged(_enabled);
+}
+
+Tg::Widget *Tg::Shortcut::parentWidget() const
+{
+    return _parentWidget;
+}
+
+bool Tg::Shortcut::isActive(const Widget *focusWidget) const
+{
+    if (_enabled == false) {
+        return false;
+    }
+
+    switch (_context) {
+    case Context::Application:
+        return true;
+    case Context::Window:
+        return focusWidget && _parentWidget
+                && focusWidget->topLevelParentWidget()
+                       == _parentWidget->topLevelParentWidget();
+    case Context::Widget:
+        return focusWidget && focusWidget == _parentWidget;
+    }
+
+    return false;
+}
+
+void Tg::Shortcut::init()
+{
+    if (_screen) {
+        _screen->registerShortcut(this);
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+
+#include <tgkeysequence.h>
+
+namespace Tg {
+class Screen;
+class Widget;
+
+/*!
+ * \brief Triggers an action when a KeySequence is pressed.
+ *
+ * Shortcut registers itself with Screen, which matches every key press
+ * against all registered shortcuts before passing it to the focused Widget.
+ * When the whole keySequence has been typed, activated() is emitted.
+ *
+ * Multi-key chords (like `Ctrl+x Ctrl+s`) are supported: while the keys typed
+ * so far form a prefix of an enabled Shortcut, they are not passed to widgets.
+ *
+ * Example:
+ *
+ * \code
+ * auto save = new Tg::Shortcut("Ctrl+x Ctrl+s", mainWindow);
+ * connect(save, &Tg::Shortcut::activated, this, &Editor::save);
+ * \endcode
+ */
+class Shortcut : public QObject
+{
+    Q_OBJECT
+
+    /*!
+     * Key sequence which activates this Shortcut.
+     */
+    Q_PROPERTY(Tg::KeySequence keySequence READ keySequence WRITE setKeySequence NOTIFY keySequenceChanged)
+
+    /*!
+     * Determines when this Shortcut is active. See Context.
+     */
+    Q_PROPERTY(Context context READ context WRITE setContext NOTIFY contextChanged)
+
+    /*!
+     * Disabled Shortcut is never activated, and does not intercept any keys.
+     */
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+
+public:
+    /*!
+     * Determines when a Shortcut is active, depending on which Widget
+     * has focus.
+     */
+    enum class Context {
+        //! Active when parent Widget has focus
+        Widget,
+        //! Active when parent Widget or any other Widget in the same top-level
+        //! Widget has focus
+        Window,
+        //! Always active
+        Application
+    };
+    Q_ENUM(Context)
+
+    /*!
+     * Constructs a Shortcut of \a sequence, with \a parent Widget and
+     * \a context.
+     */
+    Shortcut(const KeySequence &sequence, Widget *parent,
+             const Context context = Context::Window);
+
+    /*!
+     * Constructs an application-wide Shortcut of \a sequence, registered with
+     * \a screen.
+     */
+    Shortcut(const KeySequence &sequence, Screen *screen);
+
+    /*!
+     * Deregisters the Shortcut from Screen.
+     */
+    ~Shortcut();
+
+    KeySequence keySequence() const;
+    void setKeySequence(const KeySequence &keySequence);
+
+    Context context() const;
+    void setContext(const Context context);
+
+    bool enabled() const;
+    void setEnabled(const bool enabled);
+
+    /*!
+     * Returns parent Widget of this Shortcut, or `nullptr` if it was
+     * constructed with Screen as parent.
+     */
+    Widget *parentWidget() const;
+
+    /*!
+     * Returns `true` when Shortcut is enabled and its context() allows
+     * activation while \a focusWidget has focus.
+     */
+    bool isActive(const Widget *focusWidget) const;
+
+signals:
+    /*!
+     * Emitted when keySequence has been pressed.
+     */
+    void activated() const;
+
+    void keySequenceChanged(const KeySequence &keySequence) const;
+    void contextChanged(const Context context) const;
+    void enabledChanged(const bool enabled) const;
+
+private:
+    void init();
+
+    QPointer<Screen> _screen;
+    QPointer<Widget> _parentWidget;
+    KeySequence _keySequence;
+    Context _context = Context::Window;
+    bool _enabled = true;
+};
+}
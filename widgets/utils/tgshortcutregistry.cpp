@@ -0,0 +1,201 @@
+#include "tgshortcutregistry.h"
+#include "widgets/tgwidget.h"
+
+Tg::ShortcutRegistry::ShortcutRegistry()
+    : _nodes(1)
+{
+}
+
+void Tg::ShortcutRegistry::insert(Shortcut *shortcut)
+{
+    const KeySequence sequence = shortcut->keySequence();
+    if (sequence.isEmpty() || _entries.contains(shortcut)) {
+        return;
+    }
+
+    int nodeIndex = rootNode;
+    for (const KeyStroke &stroke : sequence.strokes()) {
+        const int child = _nodes.at(nodeIndex).children.value(stroke, rootNode);
+        nodeIndex = (child != rootNode)? child : addNode(nodeIndex, stroke);
+    }
+
+    _nodes[nodeIndex].shortcuts.append(shortcut);
+
+    Entry entry;
+    entry.node = nodeIndex;
+    entry.isEnabled = shortcut->enabled();
+    entry.context = shortcut->context();
+    if (entry.context == Shortcut::Context::Window && shortcut->parentWidget()) {
+        entry.widget = shortcut->parentWidget()->topLevelParentWidget();
+    } else if (entry.context == Shortcut::Context::Widget) {
+        entry.widget = shortcut->parentWidget();
+    }
+
+    _entries.insert(shortcut, entry);
+    updateCounts(entry, 1);
+}
+
+void Tg::ShortcutRegistry::remove(Shortcut *shortcut)
+{
+    const auto it = _entries.find(shortcut);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    const Entry entry = it.value();
+    _entries.erase(it);
+    _nodes[entry.node].shortcuts.removeOne(shortcut);
+    updateCounts(entry, -1);
+
+    // Remove nodes which no longer lead to any Shortcut. Their slots are
+    // reused, so the chord in progress is abandoned if it was in one of them
+    int nodeIndex = entry.node;
+    while (nodeIndex != rootNode && _nodes.at(nodeIndex).shortcutCount == 0) {
+        Node &node = _nodes[nodeIndex];
+        const int parent = node.parent;
+        _nodes[parent].children.remove(node.stroke);
+        node = Node();
+        _freeNodes.append(nodeIndex);
+
+        if (_currentNode == nodeIndex) {
+            _currentNode = rootNode;
+        }
+
+        nodeIndex = parent;
+    }
+}
+
+Tg::ShortcutRegistry::Match Tg::ShortcutRegistry::match(
+    const KeyStroke &stroke, const Widget *focusWidget, Shortcut **shortcut)
+{
+    const Match result = matchFromNode(_currentNode, stroke, focusWidget,
+                                       shortcut);
+
+    if (result == Match::NoMatch && _currentNode != rootNode) {
+        _currentNode = rootNode;
+        return matchFromNode(rootNode, stroke, focusWidget, shortcut);
+    }
+
+    return result;
+}
+
+void Tg::ShortcutRegistry::reset()
+{
+    _currentNode = rootNode;
+}
+
+Tg::ShortcutRegistry::Match Tg::ShortcutRegistry::matchFromNode(
+    const int nodeIndex, const KeyStroke &stroke, const Widget *focusWidget,
+    Shortcut **shortcut)
+{
+    const int child = _nodes.at(nodeIndex).children.value(stroke, rootNode);
+    if (child == rootNode) {
+        return Match::NoMatch;
+    }
+
+    Shortcut *best = bestShortcut(child, focusWidget);
+    if (best) {
+        *shortcut = best;
+        _currentNode = rootNode;
+        return Match::Exact;
+    }
+
+    if (hasActiveShortcut(child, focusWidget)) {
+        _currentNode = child;
+        return Match::Partial;
+    }
+
+    return Match::NoMatch;
+}
+
+bool Tg::ShortcutRegistry::hasActiveShortcut(
+    const int nodeIndex, const Widget *focusWidget) const
+{
+    const Node &node = _nodes.at(nodeIndex);
+    if (node.applicationCount > 0) {
+        return true;
+    }
+
+    if (focusWidget == nullptr) {
+        return false;
+    }
+
+    return node.windowCounts.contains(focusWidget->topLevelParentWidget())
+            || node.widgetCounts.contains(focusWidget);
+}
+
+Tg::Shortcut *Tg::ShortcutRegistry::bestShortcut(
+    const int nodeIndex, const Widget *focusWidget) const
+{
+    Shortcut *result = nullptr;
+    for (Shortcut *shortcut : _nodes.at(nodeIndex).shortcuts) {
+        if (shortcut->isActive(focusWidget) == false) {
+            continue;
+        }
+
+        if (result == nullptr || shortcut->context() < result->context()) {
+            result = shortcut;
+        }
+    }
+
+    return result;
+}
+
+int Tg::ShortcutRegistry::addNode(const int parent, const KeyStroke &stroke)
+{
+    int result = rootNode;
+    if (_freeNodes.isEmpty()) {
+        _nodes.append(Node());
+        result = _nodes.size() - 1;
+    } else {
+        result = _freeNodes.takeLast();
+    }
+
+    Node &node = _nodes[result];
+    node.parent = parent;
+    node.stroke = stroke;
+    _nodes[parent].children.insert(stroke, result);
+    return result;
+}
+
+void Tg::ShortcutRegistry::updateCounts(const Entry &entry, const int delta)
+{
+    // Every node on the path from root counts the Shortcut
+    for (int nodeIndex = entry.node; nodeIndex != -1;
+         nodeIndex = _nodes.at(nodeIndex).parent) {
+        Node &node = _nodes[nodeIndex];
+        node.shortcutCount += delta;
+
+        if (entry.isEnabled == false) {
+            continue;
+        }
+
+        switch (entry.context) {
+        case Shortcut::Context::Application:
+            node.applicationCount += delta;
+            break;
+        case Shortcut::Context::Window:
+            addCount(&node.windowCounts, entry.widget, delta);
+            break;
+        case Shortcut::Context::Widget:
+            addCount(&node.widgetCounts, entry.widget, delta);
+            break;
+        }
+    }
+}
+
+void Tg::ShortcutRegistry::addCount(QHash<const Widget *, int> *counts,
+                                    const Widget *widget, const int delta)
+{
+    // Shortcuts without a parent Widget are never active in this context
+    if (widget == nullptr) {
+        return;
+    }
+
+    const int count = counts->value(widget) + delta;
+    if (count > 0) {
+        counts->insert(widget, count);
+    } else {
+        counts->remove(widget);
+    }
+}
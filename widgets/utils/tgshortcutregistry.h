@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QVector>
+#include <QHash>
+#include <QList>
+
+#include <tgkeysequence.h>
+
+#include "tgshortcut.h"
+
+namespace Tg {
+class Widget;
+
+/*!
+ * \brief Trie of all Shortcut objects registered with a Screen.
+ *
+ * Every node of the trie corresponds to a prefix of one or more key
+ * sequences, and holds the shortcuts whose whole keySequence ends at that
+ * node. Registry remembers the node reached by the keys typed so far, so each
+ * key press is matched with a single hash lookup, no matter how many
+ * shortcuts are registered.
+ *
+ * Each node also counts enabled shortcuts ending in its subtree, by context,
+ * so checking whether a chord in progress can still complete does not walk
+ * the subtree. Nodes without any shortcuts below them are removed and their
+ * slots reused.
+ *
+ * This class is internal, it is used by Screen.
+ */
+class ShortcutRegistry
+{
+public:
+    /*!
+     * Result of matching a KeyStroke with match().
+     */
+    enum class Match {
+        //! KeyStroke is not part of any active Shortcut
+        NoMatch,
+        //! KeyStroke continues a multi-key chord, more keys are needed
+        Partial,
+        //! A Shortcut has been completed
+        Exact
+    };
+
+    ShortcutRegistry();
+
+    /*!
+     * Adds \a shortcut to the trie. Shortcuts with empty keySequence are
+     * ignored.
+     *
+     * \note Shortcut has to be removed before its keySequence, context or
+     * enabled state changes, and inserted again afterwards.
+     */
+    void insert(Shortcut *shortcut);
+
+    /*!
+     * Removes \a shortcut from the trie.
+     */
+    void remove(Shortcut *shortcut);
+
+    /*!
+     * Advances current chord by \a stroke. Only shortcuts which are active
+     * while \a focusWidget has focus are taken into account.
+     *
+     * On Match::Exact, \a shortcut is set to the most specific matching
+     * Shortcut (Widget context wins over Window, and Window over Application)
+     * and the chord is reset.
+     *
+     * If \a stroke breaks a chord in progress, the chord is reset and
+     * \a stroke is matched again, as the first key of a new chord.
+     */
+    Match match(const KeyStroke &stroke, const Widget *focusWidget,
+                Shortcut **shortcut);
+
+    /*!
+     * Abandons current chord.
+     */
+    void reset();
+
+private:
+    struct Node {
+        QHash<KeyStroke, int> children;
+        QList<Shortcut *> shortcuts;
+        int parent = -1;
+        KeyStroke stroke;
+
+        // Shortcuts ending in this node or below it
+        int shortcutCount = 0;
+        // Enabled shortcuts ending in this node or below it: Application
+        // ones, Window ones by top-level Widget and Widget ones by their
+        // parent Widget. See Shortcut::isActive()
+        int applicationCount = 0;
+        QHash<const Widget *, int> windowCounts;
+        QHash<const Widget *, int> widgetCounts;
+    };
+
+    /*!
+     * Where a Shortcut is counted in its nodes. Kept separately, because
+     * parent Widget of the Shortcut may already be gone when it is removed.
+     */
+    struct Entry {
+        int node = 0;
+        bool isEnabled = false;
+        Shortcut::Context context = Shortcut::Context::Application;
+        const Widget *widget = nullptr;
+    };
+
+    Match matchFromNode(const int nodeIndex, const KeyStroke &stroke,
+                        const Widget *focusWidget, Shortcut **shortcut);
+    bool hasActiveShortcut(const int nodeIndex, const Widget *focusWidget) const;
+    Shortcut *bestShortcut(const int nodeIndex, const Widget *focusWidget) const;
+    int addNode(const int parent, const KeyStroke &stroke);
+    void updateCounts(const Entry &entry, const int delta);
+
+    static void addCount(QHash<const Widget *, int> *counts,
+                         const Widget *widget, const int delta);
+
+    static const int rootNode = 0;
+
+    QVector<Node> _nodes;
+    QVector<int> _freeNodes;
+    QHash<const Shortcut *, Entry> _entries;
+    int _currentNode = rootNode;
+};
+}
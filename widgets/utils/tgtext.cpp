@@ -0,0 +1,122 @@
+#include "tgtext.h"
+
+#include <tgunicode.h>
+
+QVector<Tg::Text::Line> Tg::Text::wrap(const QString &text, const int width,
+                                       const Wrap mode,
+                                       const int firstLineIndent)
+{
+    QVector<Line> result;
+
+    const int size = int(text.size());
+    const bool canWrap = (mode != Wrap::Nothing) && (width > 0);
+
+    int lineStart = 0;
+    int lineIndent = firstLineIndent;
+    int column = firstLineIndent;
+    // Index and column of the last space in current line, -1 if there is none
+    int lastSpace = -1;
+    int lastSpaceColumn = -1;
+
+    auto addLine = [&result, &lineIndent](const int start, const int end,
+                                          const int endColumn) {
+        result.append(Line { start, end - start, endColumn - lineIndent });
+        lineIndent = 0;
+    };
+
+    int i = 0;
+    while (i < size) {
+        const QChar character = text.at(i);
+
+        if (character == QLatin1Char('\n')) {
+            addLine(lineStart, i, column);
+            lineStart = i + 1;
+            column = 0;
+            lastSpace = -1;
+            ++i;
+            continue;
+        }
+
+        const int next = Unicode::nextGraphemeBoundary(text, i);
+        const int characterWidth = Unicode::graphemeWidth(text, i);
+        const bool isSpace = (character == QLatin1Char(' '));
+
+        if (canWrap && column > 0 && column + characterWidth > width) {
+            if (isSpace) {
+                // Break at this space, and drop it
+                addLine(lineStart, i, column);
+                lineStart = next;
+                column = 0;
+                lastSpace = -1;
+                i = next;
+                continue;
+            }
+
+            if (mode == Wrap::Words && lastSpace != -1) {
+                // Move the word which does not fit to the next line. Current
+                // character is handled again, in the new line
+                addLine(lineStart, lastSpace, lastSpaceColumn);
+                lineStart = lastSpace + 1;
+                column -= lastSpaceColumn + 1;
+                lastSpace = -1;
+                continue;
+            }
+
+            // Wrap::Anywhere, or a word longer than the whole line
+            addLine(lineStart, i, column);
+            lineStart = i;
+            column = 0;
+            lastSpace = -1;
+        }
+
+        if (isSpace) {
+            lastSpace = i;
+            lastSpaceColumn = column;
+        }
+
+        column += characterWidth;
+        i = next;
+    }
+
+    addLine(lineStart, size, column);
+    return result;
+}
+
+int Tg::Text::positionAtColumn(const QString &text, const int column)
+{
+    const int size = int(text.size());
+    int currentColumn = 0;
+    int position = 0;
+    while (position < size) {
+        if (currentColumn == column) {
+            return position;
+        }
+
+        currentColumn += Unicode::graphemeWidth(text, position);
+        if (currentColumn > column) {
+            return -1;
+        }
+
+        position = Unicode::nextGraphemeBoundary(text, position);
+    }
+
+    return size;
+}
+
+void Tg::Text::layoutCells(const QString &text, const int start,
+                           const int length, QVector<int> *cells)
+{
+    const int end = start + length;
+    int position = start;
+    while (position < end) {
+        const int next = qMin(end, Unicode::nextGraphemeBoundary(text, position));
+        const int width = Unicode::graphemeWidth(text, position);
+        if (width > 0) {
+            cells->append(position);
+            for (int cell = 1; cell < width; ++cell) {
+                cells->append(-1);
+            }
+        }
+        position = next;
+    }
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QString>
+#include <QVector>
+
 namespace Tg {
 namespace Text {
 enum class Wrap {
@@ -7,5 +10,56 @@ enum class Wrap {
     Words,
     Anywhere
 };
+
+/*!
+ * A single line of wrapped text: \a length QChars starting at index \a start
+ * of the original string, which take \a width terminal columns. Line breaks
+ * and spaces at which text was wrapped are not part of any Line.
+ */
+struct Line {
+    int start = 0;
+    int length = 0;
+    int width = 0;
+};
+
+/*!
+ * Splits \a text into lines no wider than \a width terminal columns,
+ * according to \a mode. Hard line breaks (`\n`) always start a new line.
+ * First line starts \a firstLineIndent columns in (for example, to make
+ * room for a check box).
+ *
+ * With Wrap::Words, lines are broken at the last space which fits, and words
+ * longer than \a width are broken anywhere. With Wrap::Nothing, only hard
+ * line breaks are honoured, so lines can be wider than \a width.
+ *
+ * Text is scanned once and no substrings are created: returned lines are
+ * offsets into \a text. Lines are never broken inside a grapheme cluster,
+ * and display width of characters is taken into account (see Tg::Unicode).
+ */
+QVector<Line> wrap(const QString &text, const int width, const Wrap mode,
+                   const int firstLineIndent = 0);
+
+/*!
+ * Returns index of grapheme cluster in \a text which is drawn starting at
+ * terminal \a column. Returns `-1` if \a column is covered by a wide
+ * character which starts in the column before, and size of \a text if
+ * \a column is past its end.
+ *
+ * Widgets which draw short strings (titles, list rows) use it to find out
+ * what to print in a given cell.
+ */
+int positionAtColumn(const QString &text, const int column);
+
+/*!
+ * Appends to \a cells one entry for every terminal column taken by
+ * \a length QChars of \a text, starting at index \a start. Each entry is
+ * index of grapheme cluster drawn in that column, or `-1` if the column is
+ * covered by a wide character on its left.
+ *
+ * Widgets which draw long text use it to find what to print in a given cell
+ * in constant time.
+ */
+void layoutCells(const QString &text, const int start, const int length,
+                 QVector<int> *cells);
 };
 };
@@ -0,0 +1,126 @@
+#include "tgtimerwheel.h"
+
+Tg::TimerWheel::TimerWheel()
+{
+    _slots.fill(invalidHandle);
+}
+
+Tg::TimerWheel::Handle Tg::TimerWheel::create(Widget *owner, const int interval)
+{
+    Handle handle = invalidHandle;
+    if (_freeNodes.isEmpty()) {
+        _nodes.append(Node());
+        handle = _nodes.size() - 1;
+    } else {
+        handle = _freeNodes.takeLast();
+        _nodes[handle] = Node();
+    }
+
+    Node &node = _nodes[handle];
+    node.owner = owner;
+    node.interval = interval;
+    return handle;
+}
+
+void Tg::TimerWheel::destroy(const Handle handle)
+{
+    if (handle < 0 || handle >= _nodes.size()) {
+        return;
+    }
+
+    stop(handle);
+    _nodes[handle].owner = nullptr;
+    _freeNodes.append(handle);
+}
+
+void Tg::TimerWheel::start(const Handle handle)
+{
+    if (handle < 0 || handle >= _nodes.size()) {
+        return;
+    }
+
+    stop(handle);
+
+    Node &node = _nodes[handle];
+    const int ticks = (node.interval + tickInterval - 1) / tickInterval;
+    node.expiry = _currentTick + qMax(ticks, 1);
+    link(handle);
+}
+
+void Tg::TimerWheel::stop(const Handle handle)
+{
+    if (isActive(handle)) {
+        unlink(handle);
+    }
+}
+
+bool Tg::TimerWheel::isActive(const Handle handle) const
+{
+    if (handle < 0 || handle >= _nodes.size()) {
+        return false;
+    }
+
+    return _nodes.at(handle).slot != invalidSlot;
+}
+
+bool Tg::TimerWheel::isEmpty() const
+{
+    return _activeCount == 0;
+}
+
+void Tg::TimerWheel::link(const Handle handle)
+{
+    Node &node = _nodes[handle];
+    const qint64 delta = node.expiry - _currentTick;
+
+    int slot = invalidSlot;
+    if (delta < slotCount) {
+        slot = int(node.expiry & slotMask);
+    } else if (delta < slotCount * slotCount) {
+        slot = slotCount + int((node.expiry >> slotBits) & slotMask);
+    } else {
+        // Too far in the future: park the timer in the last slot of second
+        // level, it will be re-linked when that slot is cascaded
+        slot = slotCount + int(((_currentTick >> slotBits) + slotMask) & slotMask);
+    }
+
+    node.slot = slot;
+    node.previous = invalidHandle;
+    node.next = _slots[slot];
+    if (node.next != invalidHandle) {
+        _nodes[node.next].previous = handle;
+    }
+    _slots[slot] = handle;
+    ++_activeCount;
+}
+
+void Tg::TimerWheel::unlink(const Handle handle)
+{
+    Node &node = _nodes[handle];
+    if (node.previous != invalidHandle) {
+        _nodes[node.previous].next = node.next;
+    } else {
+        _slots[node.slot] = node.next;
+    }
+
+    if (node.next != invalidHandle) {
+        _nodes[node.next].previous = node.previous;
+    }
+
+    node.previous = invalidHandle;
+    node.next = invalidHandle;
+    node.slot = invalidSlot;
+    --_activeCount;
+}
+
+void Tg::TimerWheel::cascade()
+{
+    const int slot = slotCount + int((_currentTick >> slotBits) & slotMask);
+    Handle handle = _slots[slot];
+    while (handle != invalidHandle) {
+        const Handle next = _nodes.at(handle).next;
+        unlink(handle);
+        link(handle);
+        handle = next;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <QVector>
+
+#include <array>
+
+namespace Tg {
+class Widget;
+
+/*!
+ * \brief Hierarchical timer wheel for short UI timeouts.
+ *
+ * Screen owns a single TimerWheel and advances it from one clock, instead of
+ * every Widget owning its own QTimer objects. It is meant for short timeouts
+ * which do not need to be precise: how long a Button looks pressed, cursor
+ * blinking, tooltip delays, etc.
+ *
+ * Time is measured in ticks of tickInterval milliseconds. The first level of
+ * the wheel holds timers expiring within next slotCount ticks, one slot per
+ * tick. The second level holds timers expiring later, one slot per
+ * slotCount ticks - these are moved (cascaded) to the first level when their
+ * time comes closer. Starting, stopping and expiring a timer is therefore
+ * O(1), no matter how many timers are running.
+ *
+ * Timers are identified by a Handle, which is an index into a pool of nodes.
+ * Nodes are linked into slots by index, so once a timer is created, starting
+ * and stopping it does not allocate any memory.
+ *
+ * This class is internal, it is used by Screen.
+ *
+ * \sa Widget::createPressTimer, Widget::timerExpired
+ */
+class TimerWheel
+{
+public:
+    using Handle = int;
+
+    //! Handle which does not refer to any timer
+    static const Handle invalidHandle = -1;
+
+    //! Length of a single tick, in milliseconds. Matches frame rate of Screen
+    static const int tickInterval = 32;
+
+    TimerWheel();
+
+    /*!
+     * Creates a new (stopped) timer, which will fire after \a interval
+     * milliseconds once started. \a owner is passed to the callback of
+     * advance() when the timer expires.
+     */
+    Handle create(Widget *owner, const int interval);
+
+    /*!
+     * Stops and removes timer identified by \a handle. \a handle must not be
+     * used after this call.
+     */
+    void destroy(const Handle handle);
+
+    /*!
+     * Starts timer identified by \a handle. If the timer is already running,
+     * it is restarted.
+     */
+    void start(const Handle handle);
+
+    /*!
+     * Stops timer identified by \a handle. Does nothing when the timer is not
+     * running.
+     */
+    void stop(const Handle handle);
+
+    /*!
+     * Returns `true` if timer identified by \a handle is running.
+     */
+    bool isActive(const Handle handle) const;
+
+    /*!
+     * Returns `true` when no timers are running. Screen does not need to
+     * advance() the wheel then.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * Moves the wheel forward by \a elapsed milliseconds and calls
+     * \a callback (with owner Widget and Handle as arguments) for each timer
+     * which has expired. Expired timer is stopped before the \a callback is
+     * called, so the \a callback can start it again.
+     */
+    template<typename Callback>
+    void advance(const int elapsed, Callback callback);
+
+private:
+    struct Node {
+        Widget *owner = nullptr;
+        int interval = 0;
+        qint64 expiry = 0;
+        int previous = invalidHandle;
+        int next = invalidHandle;
+        int slot = invalidSlot;
+    };
+
+    void link(const Handle handle);
+    void unlink(const Handle handle);
+    void cascade();
+
+    static const int invalidSlot = -1;
+    static const int slotBits = 6;
+    static const int slotCount = 1 << slotBits;
+    static const int slotMask = slotCount - 1;
+
+    QVector<Node> _nodes;
+    QVector<Handle> _freeNodes;
+    std::array<Handle, 2 * slotCount> _slots;
+    qint64 _currentTick = 0;
+    int _remainder = 0;
+    int _activeCount = 0;
+};
+
+template<typename Callback>
+void TimerWheel::advance(const int elapsed, Callback callback)
+{
+    if (_activeCount == 0) {
+        _remainder = 0;
+        return;
+    }
+
+    _remainder += elapsed;
+    while (_remainder >= tickInterval && _activeCount > 0) {
+        _remainder -= tickInterval;
+        ++_currentTick;
+
+        if ((_currentTick & slotMask) == 0) {
+            cascade();
+        }
+
+        // Timers started by the callback always land in a different slot
+        // (their expiry is at least 1 tick away), so this loop terminates
+        const int slot = int(_currentTick & slotMask);
+        while (_slots[slot] != invalidHandle) {
+            const Handle handle = _slots[slot];
+            unlink(handle);
+            callback(_nodes.at(handle).owner, handle);
+        }
+    }
+
+    if (_activeCount == 0) {
+        _remainder = 0;
+    }
+}
+}
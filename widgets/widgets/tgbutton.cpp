@@ -2,6 +2,8 @@
 #include "utils/tghelpers.h"
 #include "styles/tgstyle.h"
 
+static_assert(sizeof(Tg::Button) <= 456, "Tg::Button has grown");
+
 Tg::Button::Button(Tg::Widget *parent) : Tg::Label(parent)
 {
     Button::init();
@@ -26,62 +28,39 @@ Tg::Button::Button(const QString &text, Tg::Screen *screen)
 
 Tg::Color Tg::Button::activeTextColor() const
 {
-    if (_activeTextColor.isEmpty()) {
-        return style()->activeTextColor;
-    } else {
-        return _activeTextColor;
-    }
+    return resolvedStyle().activeTextColor;
 }
 
 Tg::Color Tg::Button::activeBackgroundColor() const
 {
-    if (_activeBackgroundColor.isEmpty()) {
-        return style()->activeBackgroundColor;
-    } else {
-        return _activeBackgroundColor;
-    }
+    return resolvedStyle().activeBackgroundColor;
 }
 
 Tg::Color Tg::Button::inactiveTextColor() const
 {
-    if (_inactiveTextColor.isEmpty()) {
-        return style()->inactiveTextColor;
-    } else {
-        return _inactiveTextColor;
-    }
+    return resolvedStyle().inactiveTextColor;
 }
 
 Tg::Color Tg::Button::inactiveBackgroundColor() const
 {
-    if (_inactiveBackgroundColor.isEmpty()) {
-        return style()->inactiveBackgroundColor;
-    } else {
-        return _inactiveBackgroundColor;
-    }
+    return resolvedStyle().inactiveBackgroundColor;
 }
 
 Tg::Color Tg::Button::pressedTextColor() const
 {
-    if (_pressedTextColor.isEmpty()) {
-        return style()->pressedTextColor;
-    } else {
-        return _pressedTextColor;
-    }
+    return resolvedStyle().pressedTextColor;
 }
 
 Tg::Color Tg::Button::pressedBackgroundColor() const
 {
-    if (_pressedBackgroundColor.isEmpty()) {
-        return style()->pressedBackgroundColor;
-    } else {
-        return _pressedBackgroundColor;
-    }
+    return resolvedStyle().pressedBackgroundColor;
 }
 
 void Tg::Button::click()
 {
     setTextColor(pressedTextColor());
     setBackgroundColor(pressedBackgroundColor());
+    restartTimer(_buttonPressTimer);
 
     emit clicked();
 }
@@ -92,6 +71,8 @@ void Tg::Button::setActiveTextColor(const Tg::Color &activeTextColor)
         return;
 
     _activeTextColor = activeTextColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ActiveTextColor);
     emit activeTextColorChanged(_activeTextColor);
 }
 
@@ -101,6 +82,8 @@ void Tg::Button::setActiveBackgroundColor(const Tg::Color &activeBackgroundColor
         return;
 
     _activeBackgroundColor = activeBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ActiveBackgroundColor);
     emit activeBackgroundColorChanged(_activeBackgroundColor);
 }
 
@@ -110,6 +93,8 @@ void Tg::Button::setInactiveTextColor(const Tg::Color &inactiveTextColor)
         return;
 
     _inactiveTextColor = inactiveTextColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::InactiveTextColor);
     emit inactiveTextColorChanged(_inactiveTextColor);
 }
 
@@ -119,6 +104,8 @@ void Tg::Button::setInactiveBackgroundColor(const Tg::Color &inactiveBackgroundC
         return;
 
     _inactiveBackgroundColor = inactiveBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::InactiveBackgroundColor);
     emit inactiveBackgroundColorChanged(_inactiveBackgroundColor);
 }
 
@@ -128,6 +115,8 @@ void Tg::Button::setPressedTextColor(const Tg::Color &pressedTextColor)
         return;
 
     _pressedTextColor = pressedTextColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::PressedTextColor);
     emit pressedTextColorChanged(_pressedTextColor);
 }
 
@@ -137,9 +126,69 @@ void Tg::Button::setPressedBackgroundColor(const Tg::Color &pressedBackgroundCol
         return;
 
     _pressedBackgroundColor = pressedBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::PressedBackgroundColor);
     emit pressedBackgroundColorChanged(_pressedBackgroundColor);
 }
 
+void Tg::Button::applyStyleOverrides(Style *resolved) const
+{
+    Label::applyStyleOverrides(resolved);
+
+    if (_activeTextColor.isEmpty() == false) {
+        resolved->activeTextColor = _activeTextColor;
+    }
+
+    if (_activeBackgroundColor.isEmpty() == false) {
+        resolved->activeBackgroundColor = _activeBackgroundColor;
+    }
+
+    if (_inactiveTextColor.isEmpty() == false) {
+        resolved->inactiveTextColor = _inactiveTextColor;
+    }
+
+    if (_inactiveBackgroundColor.isEmpty() == false) {
+        resolved->inactiveBackgroundColor = _inactiveBackgroundColor;
+    }
+
+    if (_pressedTextColor.isEmpty() == false) {
+        resolved->pressedTextColor = _pressedTextColor;
+    }
+
+    if (_pressedBackgroundColor.isEmpty() == false) {
+        resolved->pressedBackgroundColor = _pressedBackgroundColor;
+    }
+}
+
+bool Tg::Button::hasStyleOverrides() const
+{
+    return Label::hasStyleOverrides()
+            || _activeTextColor.isEmpty() == false
+            || _activeBackgroundColor.isEmpty() == false
+            || _inactiveTextColor.isEmpty() == false
+            || _inactiveBackgroundColor.isEmpty() == false
+            || _pressedTextColor.isEmpty() == false
+            || _pressedBackgroundColor.isEmpty() == false;
+}
+
+void Tg::Button::propertyChanged(const int property)
+{
+    Label::propertyChanged(property);
+
+    if (property == PropertyId::HasFocus) {
+        onHasFocusChanged();
+    }
+}
+
+void Tg::Button::timerExpired(const TimerWheel::Handle handle)
+{
+    Label::timerExpired(handle);
+
+    if (handle == _buttonPressTimer) {
+        onButtonPressTimeout();
+    }
+}
+
 void Tg::Button::init()
 {
     setAcceptsFocus(true);
@@ -147,29 +196,9 @@ void Tg::Button::init()
 
     Label::init();
 
-    // TODO: move these connects into setupPressTimer() somehow!
-    CHECK(connect(this, &Button::clicked,
-                  &_buttonPressTimer, qOverload<>(&QTimer::start)));
-    CHECK(connect(&_buttonPressTimer, &QTimer::timeout,
-                  this, &Button::onButtonPressTimeout));
-    setupPressTimer(&_buttonPressTimer);
-
-
-    CHECK(connect(this, &Button::hasFocusChanged,
-                  this, &Button::onHasFocusChanged));
-
-    CHECK(connect(this, &Button::activeTextColorChanged,
-                  this, &Button::schedulePartialRedraw));
-    CHECK(connect(this, &Button::activeBackgroundColorChanged,
-                  this, &Button::schedulePartialRedraw));
-    CHECK(connect(this, &Button::inactiveTextColorChanged,
-                  this, &Button::schedulePartialRedraw));
-    CHECK(connect(this, &Button::inactiveBackgroundColorChanged,
-                  this, &Button::schedulePartialRedraw));
-    CHECK(connect(this, &Button::pressedTextColorChanged,
-                  this, &Button::schedulePartialRedraw));
-    CHECK(connect(this, &Button::pressedBackgroundColorChanged,
-                  this, &Button::schedulePartialRedraw));
+    if (_buttonPressTimer == TimerWheel::invalidHandle) {
+        _buttonPressTimer = createPressTimer();
+    }
 
     if (hasFocus()) {
         setBackgroundColor(activeBackgroundColor());
@@ -180,11 +209,19 @@ void Tg::Button::init()
     }
 }
 
-bool Tg::Button::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::Button::keyPressEvent(const KeyEvent &event)
+{
+    if (event.key() == Key::Code::Enter) {
+        click();
+        return true;
+    }
+
+    return false;
+}
+
+bool Tg::Button::mousePressEvent(const MouseEvent &event)
 {
-    if (keyboardBuffer.contains(Tg::Key::enter)
-        || keyboardBuffer.contains(Tg::Key::ret))
-    {
+    if (event.button() == MouseButton::Left) {
         click();
         return true;
     }
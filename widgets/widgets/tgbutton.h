@@ -2,8 +2,6 @@
 
 #include <widgets/tglabel.h>
 
-#include <QTimer>
-
 namespace Tg {
 class Button : public Label
 {
@@ -52,15 +50,35 @@ signals:
     void pressedBackgroundColorChanged(const Tg::Color &pressedBackgroundColor) const;
 
 protected:
+    /*!
+     * Properties of Button, see Widget::PropertyId.
+     */
+    struct PropertyId : Label::PropertyId {
+        enum : int {
+            ActiveTextColor = Label::PropertyId::Last,
+            ActiveBackgroundColor,
+            InactiveTextColor,
+            InactiveBackgroundColor,
+            PressedTextColor,
+            PressedBackgroundColor,
+            Last
+        };
+    };
+
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    void applyStyleOverrides(Style *resolved) const override;
+    bool hasStyleOverrides() const override;
+    void propertyChanged(const int property) override;
+    void timerExpired(const TimerWheel::Handle handle) override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool mousePressEvent(const MouseEvent &event) override;
 
 protected slots:
     void onButtonPressTimeout();
     void onHasFocusChanged();
 
 private:
-    QTimer _buttonPressTimer;
+    TimerWheel::Handle _buttonPressTimer = TimerWheel::invalidHandle;
     Tg::Color _activeTextColor;
     Tg::Color _activeBackgroundColor;
     Tg::Color _inactiveTextColor;
@@ -1,6 +1,8 @@
 #include "tgcheckbox.h"
 #include "styles/tgstyle.h"
 
+static_assert(sizeof(Tg::CheckBox) <= 456, "Tg::CheckBox has grown");
+
 Tg::CheckBox::CheckBox(Tg::Widget *parent) : Tg::Button(parent)
 {
     CheckBox::init();
@@ -72,16 +74,16 @@ void Tg::CheckBox::init()
                   this, &CheckBox::toggleState));
 }
 
-bool Tg::CheckBox::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::CheckBox::keyPressEvent(const KeyEvent &event)
 {
-    if (keyboardBuffer.contains(Tg::Key::space)) {
+    if (event.key() == Key::Code::Space) {
         setTextColor(pressedTextColor());
         setBackgroundColor(pressedBackgroundColor());
         emit clicked();
         return true;
     }
 
-    return Button::consumeKeyboardBuffer(keyboardBuffer);
+    return Button::keyPressEvent(event);
 }
 
 QString Tg::CheckBox::checkBoxText() const
@@ -29,7 +29,7 @@ public slots:
 
 protected:
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    bool keyPressEvent(const KeyEvent &event) override;
     QString checkBoxText() const;
 
 private:
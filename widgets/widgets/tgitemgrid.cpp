@@ -0,0 +1,273 @@
+#include "tgitemgrid.h"
+#include "utils/tgtext.h"
+
+#include <tgkey.h>
+#include <tgunicode.h>
+
+#include <QRect>
+
+static_assert(sizeof(Tg::ItemGrid) <= 248, "Tg::ItemGrid has grown");
+
+Tg::ItemGrid::ItemGrid(Tg::Widget *parent) : Tg::Widget(parent)
+{
+    ItemGrid::init();
+}
+
+Tg::ItemGrid::ItemGrid(Tg::Screen *screen) : Tg::Widget(screen)
+{
+    ItemGrid::init();
+}
+
+QSize Tg::ItemGrid::cellSize() const
+{
+    return _cellSize;
+}
+
+int Tg::ItemGrid::columnCount() const
+{
+    return _columnCount;
+}
+
+int Tg::ItemGrid::currentIndex() const
+{
+    return _currentIndex;
+}
+
+int Tg::ItemGrid::effectiveColumnCount() const
+{
+    if (_columnCount > 0) {
+        return _columnCount;
+    }
+
+    return qMax(1, contentsRectangle().width() / _cellSize.width());
+}
+
+const QVector<Tg::GridItem> &Tg::ItemGrid::items() const
+{
+    return _items;
+}
+
+void Tg::ItemGrid::setItems(const QVector<GridItem> &items)
+{
+    _items = items;
+    propertyChanged(PropertyId::Items);
+    emit itemsChanged();
+}
+
+int Tg::ItemGrid::count() const
+{
+    return _items.size();
+}
+
+Tg::GridItem Tg::ItemGrid::item(const int index) const
+{
+    return _items.value(index);
+}
+
+void Tg::ItemGrid::setItem(const int index, const GridItem &item)
+{
+    if (index < 0 || index >= _items.size()) {
+        return;
+    }
+
+    _items[index] = item;
+    scheduleItemRedraw(index);
+    emit itemsChanged();
+}
+
+QRect Tg::ItemGrid::itemRectangle(const int index) const
+{
+    if (index < 0 || index >= _items.size()) {
+        return QRect();
+    }
+
+    const int columns = effectiveColumnCount();
+    const QPoint topLeft((index % columns) * _cellSize.width(),
+                         (index / columns) * _cellSize.height());
+    return QRect(topLeft, _cellSize);
+}
+
+int Tg::ItemGrid::itemAt(const QPoint &pixel) const
+{
+    const QRect contents = contentsRectangle();
+    if (contents.contains(pixel) == false) {
+        return -1;
+    }
+
+    const QPoint contentsPixel(pixel - contents.topLeft());
+    const int columns = effectiveColumnCount();
+    const int column = contentsPixel.x() / _cellSize.width();
+    if (column >= columns) {
+        return -1;
+    }
+
+    const int index = (contentsPixel.y() / _cellSize.height()) * columns + column;
+    if (index >= _items.size()) {
+        return -1;
+    }
+
+    return index;
+}
+
+void Tg::ItemGrid::setCellSize(const QSize &cellSize)
+{
+    // Cells must be at least 1x1, item positions are computed by division
+    const QSize size = cellSize.expandedTo(QSize(1, 1));
+    if (_cellSize == size)
+        return;
+
+    _cellSize = size;
+    propertyChanged(PropertyId::CellSize);
+    emit cellSizeChanged(_cellSize);
+}
+
+void Tg::ItemGrid::setColumnCount(const int columnCount)
+{
+    if (_columnCount == columnCount)
+        return;
+
+    _columnCount = columnCount;
+    propertyChanged(PropertyId::ColumnCount);
+    emit columnCountChanged(_columnCount);
+}
+
+void Tg::ItemGrid::setCurrentIndex(const int currentIndex)
+{
+    if (_currentIndex == currentIndex)
+        return;
+
+    // Only the two affected cells are redrawn, not the whole grid
+    const int previousIndex = _currentIndex;
+    _currentIndex = currentIndex;
+    scheduleItemRedraw(previousIndex);
+    scheduleItemRedraw(_currentIndex);
+    emit currentIndexChanged(_currentIndex);
+}
+
+void Tg::ItemGrid::init()
+{
+    setAcceptsFocus(true);
+
+    Widget::init();
+}
+
+bool Tg::ItemGrid::keyPressEvent(const KeyEvent &event)
+{
+    if (_items.isEmpty()) {
+        return false;
+    }
+
+    const int columns = effectiveColumnCount();
+    int index = _currentIndex;
+
+    switch (event.key()) {
+    case Key::Code::Left:
+        index -= event.count();
+        break;
+    case Key::Code::Right:
+        index += event.count();
+        break;
+    case Key::Code::Up:
+        index -= columns * event.count();
+        break;
+    case Key::Code::Down:
+        index += columns * event.count();
+        break;
+    case Key::Code::Home:
+        index = 0;
+        break;
+    case Key::Code::End:
+        index = _items.size() - 1;
+        break;
+    case Key::Code::Enter:
+    case Key::Code::Space:
+        if (_currentIndex >= 0 && _currentIndex < _items.size()) {
+            emit itemPressed(_currentIndex);
+        }
+        return true;
+    default:
+        return false;
+    }
+
+    setCurrentIndex(qBound(0, index, int(_items.size()) - 1));
+    return true;
+}
+
+bool Tg::ItemGrid::mousePressEvent(const MouseEvent &event)
+{
+    if (event.button() != MouseButton::Left) {
+        return false;
+    }
+
+    const int index = itemAt(mapFromGlobal(event.position()));
+    if (index == -1) {
+        return false;
+    }
+
+    setCurrentIndex(index);
+    emit itemPressed(index);
+    return true;
+}
+
+QString Tg::ItemGrid::drawPixel(const QPoint &pixel) const
+{
+    if (isBorder(pixel)) {
+        return drawBorderPixel(pixel);
+    }
+
+    const int index = itemAt(pixel);
+    if (index == -1) {
+        return Widget::drawPixel(pixel);
+    }
+
+    const GridItem &item = _items.at(index);
+    const QRect rectangle = itemRectangle(index);
+    const QPoint cellPixel(pixel - contentsRectangle().topLeft()
+                           - rectangle.topLeft());
+
+    const Tg::Color itemTextColor = item.textColor.isEmpty()?
+                textColor() : item.textColor;
+    const Tg::Color itemBackgroundColor = item.backgroundColor.isEmpty()?
+                backgroundColor() : item.backgroundColor;
+
+    QString result;
+    if (hasFocus() && index == _currentIndex) {
+        result.append(Tg::Color::code(itemBackgroundColor, itemTextColor));
+    } else {
+        result.append(Tg::Color::code(itemTextColor, itemBackgroundColor));
+    }
+
+    if (cellPixel.y() != 0) {
+        result.append(Tg::Key::space);
+        return result;
+    }
+
+    // Item text is no wider than a cell, so it is laid out on the fly
+    const int position = Text::positionAtColumn(item.text, cellPixel.x());
+    if (position == -1) {
+        // Nothing is printed in a column covered by a wide character
+        return result;
+    }
+
+    // Wide characters which do not fit in the cell are not drawn
+    if (position >= item.text.size()
+            || Unicode::graphemeWidth(item.text, position)
+               > _cellSize.width() - cellPixel.x()) {
+        result.append(Tg::Key::space);
+        return result;
+    }
+
+    const int end = Unicode::nextGraphemeBoundary(item.text, position);
+    result.append(item.text.constData() + position, end - position);
+    return result;
+}
+
+void Tg::ItemGrid::scheduleItemRedraw(const int index) const
+{
+    const QRect rectangle = itemRectangle(index);
+    if (rectangle.isEmpty()) {
+        return;
+    }
+
+    scheduleRectangleRedraw(rectangle.translated(contentsRectangle().topLeft()));
+}
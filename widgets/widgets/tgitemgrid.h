@@ -0,0 +1,143 @@
+#pragma once
+
+#include <widgets/tgwidget.h>
+
+#include <QString>
+#include <QVector>
+
+namespace Tg {
+/*!
+ * A single cell of ItemGrid.
+ *
+ * GridItem is a plain value, not a Widget: it has no signals, properties,
+ * style or layout of its own. When textColor or backgroundColor is empty,
+ * colors of the ItemGrid are used.
+ */
+struct GridItem {
+    QString text;
+    Tg::Color textColor;
+    Tg::Color backgroundColor;
+};
+
+/*!
+ * \brief Shows a large number of uniform cells, without a Widget per cell.
+ *
+ * ItemGrid keeps its items in a single contiguous array and lays them out in
+ * rows of columnCount() cells, each of cellSize(). Position of an item is
+ * computed from its index, so layout, drawing and hit-testing cost nothing
+ * per item, no matter how many items there are.
+ *
+ * Use it instead of many small widgets for homogeneous content, like a matrix
+ * of status indicators:
+ *
+ * \code
+ * auto grid = new Tg::ItemGrid(parent);
+ * grid->setCellSize(QSize(2, 1));
+ * grid->setColumnCount(64);
+ * grid->setItems(QVector<Tg::GridItem>(64 * 64, { "ok", {}, {} }));
+ * grid->setItem(100, { "!!", Tg::Color::Predefined::Red, {} });
+ * \endcode
+ *
+ * When clicked, itemPressed() is emitted with index of the item under mouse.
+ * ItemGrid can also be used with keyboard: arrow keys, Home and End move
+ * currentIndex, Enter and Space press the current item.
+ */
+class ItemGrid : public Widget
+{
+    Q_OBJECT
+
+    /*!
+     * Size of every cell. Text of an item is drawn in the first line of its
+     * cell, and is cut if it is longer than cell width.
+     */
+    Q_PROPERTY(QSize cellSize READ cellSize WRITE setCellSize NOTIFY cellSizeChanged)
+
+    /*!
+     * Number of cells in each row. When 0 (the default), as many cells as fit
+     * the width of the ItemGrid are placed in each row.
+     */
+    Q_PROPERTY(int columnCount READ columnCount WRITE setColumnCount NOTIFY columnCountChanged)
+
+    /*!
+     * Index of the item selected with keyboard. It is drawn with inverted
+     * colors while ItemGrid has focus.
+     */
+    Q_PROPERTY(int currentIndex READ currentIndex WRITE setCurrentIndex NOTIFY currentIndexChanged)
+
+public:
+    ItemGrid(Widget *parent);
+    ItemGrid(Screen *screen);
+
+    QSize cellSize() const;
+    int columnCount() const;
+    int currentIndex() const;
+
+    /*!
+     * Returns number of columns used for laying out items - either
+     * columnCount(), or the number of cells which fit contents width.
+     */
+    int effectiveColumnCount() const;
+
+    const QVector<GridItem> &items() const;
+    void setItems(const QVector<GridItem> &items);
+
+    int count() const;
+    GridItem item(const int index) const;
+
+    /*!
+     * Replaces item at \a index with \a item. Does nothing if \a index is out
+     * of range. Only the cell of the item is redrawn.
+     */
+    void setItem(const int index, const GridItem &item);
+
+    /*!
+     * Returns rectangle occupied by item at \a index, in coordinates of
+     * contentsRectangle().
+     */
+    QRect itemRectangle(const int index) const;
+
+    /*!
+     * Returns index of item drawn at \a pixel (in this Widget's coordinates),
+     * or `-1` if there is no item there.
+     */
+    int itemAt(const QPoint &pixel) const;
+
+public slots:
+    void setCellSize(const QSize &cellSize);
+    void setColumnCount(const int columnCount);
+    void setCurrentIndex(const int currentIndex);
+
+signals:
+    void cellSizeChanged(const QSize &cellSize) const;
+    void columnCountChanged(const int columnCount) const;
+    void currentIndexChanged(const int currentIndex) const;
+    void itemsChanged() const;
+    void itemPressed(const int index) const;
+
+protected:
+    /*!
+     * Properties of ItemGrid, see Widget::PropertyId.
+     */
+    struct PropertyId : Widget::PropertyId {
+        enum : int {
+            CellSize = Widget::PropertyId::Last,
+            ColumnCount,
+            Items,
+            Last
+        };
+    };
+
+    void init() override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool mousePressEvent(const MouseEvent &event) override;
+    QString drawPixel(const QPoint &pixel) const override;
+
+private:
+    void scheduleItemRedraw(const int index) const;
+
+    QVector<GridItem> _items;
+    QSize _cellSize = { 1, 1 };
+    int _columnCount = 0;
+    int _currentIndex = 0;
+};
+}
@@ -4,6 +4,7 @@
 
 #include <tgkey.h>
 #include <tgcommand.h>
+#include <tgunicode.h>
 
 #include <QChar>
 #include <QRect>
@@ -11,6 +12,8 @@
 
 #include <algorithm>
 
+static_assert(sizeof(Tg::Label) <= 400, "Tg::Label has grown");
+
 Tg::Label::Label(Tg::Widget *parent) : Tg::Widget(parent)
 {
     Label::init();
@@ -51,16 +54,21 @@ QString Tg::Label::drawPixel(const QPoint &pixel) const
     const int charX = pixel.x() - contents.x();
     const int charY = pixel.y() - contents.y();
 
-    const QStringList wrappedText(_laidOutTextCache);
-
-    if (charY < wrappedText.size()) {
-        const QString line(wrappedText.at(charY));
-
-        if (line.size() > charX) {
-            if (highlighted()) {
-                result.append(Tg::Command::bold);
+    if (charY >= 0 && charY < laidOutLineCount()) {
+        const int lineStart = _laidOutLineOffsets.at(charY);
+        const int lineWidth = _laidOutLineOffsets.at(charY + 1) - lineStart;
+
+        if (charX >= 0 && charX < lineWidth) {
+            const int position = _laidOutCells.at(lineStart + charX);
+            // Nothing is printed in cells covered by a wide character, the
+            // terminal advances past them on its own
+            if (position != -1) {
+                if (highlighted()) {
+                    result.append(Tg::Command::bold);
+                }
+                const int end = Unicode::nextGraphemeBoundary(_laidOutText, position);
+                result.append(_laidOutText.constData() + position, end - position);
             }
-            result.append(line.at(charX).unicode());
         } else {
             result.append(Tg::Key::space);
         }
@@ -84,7 +92,8 @@ void Tg::Label::setText(const QString &text, const bool expand)
     _text = text;
 
     QSize current(size());
-    if (expand && current.width() != _text.length()) {
+    const int textWidth = Unicode::width(_text);
+    if (expand && current.width() != textWidth) {
         QSize parentSize(current);
         if (parentWidget()) {
             parentSize = parentWidget()->contentsRectangle().size();
@@ -92,15 +101,17 @@ void Tg::Label::setText(const QString &text, const bool expand)
             parentSize.setWidth(parentSize.width() - effectiveBorderWidth());
         }
 
-        current.setWidth(std::min(qsizetype(parentSize.width()), qsizetype(text.length())));
+        current.setWidth(std::min(parentSize.width(), textWidth));
 
-        const auto shortLayout = generateTextLayout(QSize(current.width(), 1), _text);
+        const auto lines = Text::wrap(_text, current.width(), _wrapMode,
+                                      Unicode::width(_reservedText));
 
-        current.setHeight(std::min(qsizetype(parentSize.height()), qsizetype(shortLayout.text.size())));
+        current.setHeight(std::min(qsizetype(parentSize.height()), qsizetype(lines.size())));
 
         setSize(current);
     }
 
+    propertyChanged(PropertyId::Text);
     emit textChanged(_text);
 }
 
@@ -110,129 +121,76 @@ void Tg::Label::setHighlighted(const bool highlighted)
         return;
 
     _highlighted = highlighted;
+    propertyChanged(PropertyId::Highlighted);
     emit highlightedChanged(_highlighted);
 }
 
 void Tg::Label::init()
 {
-    CHECK(connect(this, &Label::needsRedraw,
-                  this, &Label::layoutText));
-    CHECK(connect(this, &Label::textChanged,
-                  this, &Label::schedulePartialRedraw));
-    CHECK(connect(this, &Label::highlightedChanged,
-                  this, &Label::schedulePartialRedraw));
+    // Subclasses run this again, see Widget::init()
+    connect(this, &Label::needsRedraw, this, &Label::layoutText,
+            Qt::UniqueConnection);
 
     Widget::init();
 }
 
 void Tg::Label::layoutText()
 {
-    const auto result = generateTextLayout(contentsRectangle().size(), text());
-    _laidOutTextCache = result.text;
-    setWidgetOvershoot(result.overshoot);
-}
-
-Tg::Label::TextLayout Tg::Label::generateTextLayout(const QSize &size, const QString &text) const
-{
-    TextLayout result;
+    // Redraws caused by color, focus or position changes do not affect the
+    // text layout, so it is only regenerated when one of its inputs changes
+    const QSize size = contentsRectangle().size();
+    if (_isTextLayoutValid && _layoutInputSize == size
+            && _layoutInputWrapMode == _wrapMode
+            && _layoutInputText == _text
+            && _layoutInputReservedText == _reservedText) {
+        return;
+    }
 
-    const int width = size.width();
-    const int height = size.height();
     const int reserved = reservedCharactersCount();
-
-    // TODO: implement handling for _wrapMode
-    // TODO: implement handling for newlines in short strings
-
-    if ((text.size() + reserved) <= width) {
-        QString txt;
-
-        if (reserved != 0) {
-            txt.append(reservedText());
-        }
-
-        txt.append(text);
-        while (txt.length() < width) {
-            // Fill with spaces
-            txt.append(Tg::Key::space);
-        }
-        result.text.append(txt);
-
-        if (height < 1) {
-            result.overshoot = Overshoot::Vertical;
+    const int reservedWidth = Unicode::width(_reservedText);
+    _laidOutText = _reservedText + _text;
+    const auto lines = Text::wrap(_text, size.width(), _wrapMode, reservedWidth);
+
+    _laidOutCells.clear();
+    _laidOutLineOffsets.clear();
+    _laidOutLineOffsets.reserve(lines.size() + 1);
+
+    SizeOvershoot overshoot = Overshoot::None;
+    for (int i = 0; i < lines.size(); ++i) {
+        // Lines point into _text, shift them to account for reserved text
+        // which precedes it in the first line
+        Text::Line line = lines.at(i);
+        if (i == 0) {
+            line.length += reserved;
+            line.width += reservedWidth;
         } else {
-            result.overshoot = Overshoot::None;
+            line.start += reserved;
         }
-    } else {
-        int currentX = 0;
-        int currentY = 0;
-        QString currentString;
 
-        if (currentX == 0 && currentY == 0 && reserved != 0) {
-            currentString.append(reservedText());
-            currentX += reserved;
+        if (line.width > size.width()) {
+            overshoot = overshoot | Overshoot::Horizontal;
         }
 
-        const QStringList lines(text.split("\n"));
-        for (const QString &line : lines) {
-            const QStringList words(line.split(' '));
-            for (const QString &word : words) {
-                if (wrapMode() == Text::Wrap::Words) {
-                    if (currentX + word.length() > width) {
-                        breakLine(QChar(), &currentX, &currentY,
-                                  &currentString, &result.text);
-                    }
-                }
-
-                for (const QChar &character : word) {
-                    if (currentY >= height) {
-                        result.overshoot = result.overshoot | Overshoot::Vertical;
-                        break;
-                    }
-
-                    if (currentX < width) {
-                        currentString.append(character);
-                        currentX++;
-                    } else {
-                        breakLine(character, &currentX, &currentY,
-                                  &currentString, &result.text);
-                    }
-                }
-
-                if (currentX < width) {
-                    currentX++;
-                    currentString.append(' ');
-                }
-            }
-
-            breakLine(QChar(), &currentX, &currentY,
-                      &currentString, &result.text);
-        }
+        _laidOutLineOffsets.append(_laidOutCells.size());
+        Text::layoutCells(_laidOutText, line.start, line.length, &_laidOutCells);
+    }
+    _laidOutLineOffsets.append(_laidOutCells.size());
 
-        while (currentString.length() < width) {
-            // Fill with spaces
-            currentString.append(Tg::Key::space);
-        }
-        result.text.append(currentString);
+    if (lines.size() > size.height()) {
+        overshoot = overshoot | Overshoot::Vertical;
     }
 
-    return result;
+    _layoutInputText = _text;
+    _layoutInputReservedText = _reservedText;
+    _layoutInputWrapMode = _wrapMode;
+    _layoutInputSize = size;
+    _isTextLayoutValid = true;
+    setWidgetOvershoot(overshoot);
 }
 
-void Tg::Label::breakLine(const QChar &character,
-                          int *currentX, int *currentY,
-                          QString *currentString, QStringList *result) const
+int Tg::Label::laidOutLineCount() const
 {
-    result->append(*currentString);
-    currentString->clear();
-    currentY++;
-
-    if (character.isNull()) {
-        *currentX = 0;
-    } else {
-        currentString->append(character);
-        // One because one character is already added, in line above
-        *currentX = 1;
-    }
+    return qMax(0, int(_laidOutLineOffsets.size()) - 1);
 }
 
 int Tg::Label::reservedCharactersCount() const
@@ -249,6 +207,7 @@ void Tg::Label::setReservedText(const QString &reserved)
 {
     if (_reservedText != reserved) {
         _reservedText = reserved;
+        propertyChanged(PropertyId::Text);
         emit textChanged(text());
     }
 }
@@ -3,6 +3,8 @@
 #include <widgets/tgwidget.h>
 #include <utils/tgtext.h>
 
+#include <QVector>
+
 namespace Tg {
 class Label : public Widget
 {
@@ -35,6 +37,17 @@ public slots:
     void setHighlighted(const bool highlighted);
 
 protected:
+    /*!
+     * Properties of Label, see Widget::PropertyId.
+     */
+    struct PropertyId : Widget::PropertyId {
+        enum : int {
+            Text = Widget::PropertyId::Last,
+            Highlighted,
+            Last
+        };
+    };
+
     void init() override;
     QString drawPixel(const QPoint &pixel) const override;
 
@@ -46,21 +59,27 @@ private slots:
     void layoutText();
 
 private:
-    struct TextLayout {
-        QStringList text;
-        SizeOvershoot overshoot = Overshoot::None;
-    };
-
-    TextLayout generateTextLayout(const QSize &size, const QString &text) const;
-    void breakLine(const QChar &character, int *currentX, int *currentY,
-                   QString *currentString,
-                   QStringList *result) const;
+    int laidOutLineCount() const;
 
     bool _highlighted = false;
     Text::Wrap _wrapMode = Text::Wrap::Words;
 
     QString _text;
     QString _reservedText;
-    QStringList _laidOutTextCache;
+
+    // Reserved text followed by text, and terminal cells it is laid out
+    // into. Each cell holds index of the grapheme cluster drawn in it, or -1
+    // when it is covered by a wide character on its left. Line N occupies
+    // cells from _laidOutLineOffsets[N] up to _laidOutLineOffsets[N + 1]
+    QString _laidOutText;
+    QVector<int> _laidOutCells;
+    QVector<int> _laidOutLineOffsets;
+
+    // Inputs used to generate _laidOutText, see layoutText()
+    QString _layoutInputText;
+    QString _layoutInputReservedText;
+    Text::Wrap _layoutInputWrapMode = Text::Wrap::Words;
+    QSize _layoutInputSize;
+    bool _isTextLayoutValid = false;
 };
 }
@@ -3,8 +3,12 @@
 #include "utils/tghelpers.h"
 #include "styles/tgstyle.h"
 
+#include <tgunicode.h>
+
 #include <QRect>
 
+static_assert(sizeof(Tg::LineEdit) <= 472, "Tg::LineEdit has grown");
+
 Tg::LineEdit::LineEdit(Tg::Widget *parent) : Tg::Label(parent)
 {
     LineEdit::init();
@@ -43,20 +47,12 @@ int Tg::LineEdit::cursorPosition() const
 
 Tg::Color Tg::LineEdit::placeholderTextColor() const
 {
-    if (_placeholderTextColor.isEmpty()) {
-        return style()->placeholderTextColor;
-    } else {
-        return _placeholderTextColor;
-    }
+    return resolvedStyle().placeholderTextColor;
 }
 
 Tg::Color Tg::LineEdit::placeholderBackgroundColor() const
 {
-    if (_placeholderBackgroundColor.isEmpty()) {
-        return style()->placeholderBackgroundColor;
-    } else {
-        return _placeholderBackgroundColor;
-    }
+    return resolvedStyle().placeholderBackgroundColor;
 }
 
 void Tg::LineEdit::setPlaceholderText(const QString &placeholderText)
@@ -65,6 +61,7 @@ void Tg::LineEdit::setPlaceholderText(const QString &placeholderText)
         return;
 
     _placeholderText = placeholderText;
+    propertyChanged(PropertyId::PlaceholderText);
     emit placeholderTextChanged(_placeholderText);
 }
 
@@ -74,6 +71,7 @@ void Tg::LineEdit::setCursorPosition(const int cursorPosition)
         return;
 
     _cursorPosition = cursorPosition;
+    propertyChanged(PropertyId::CursorPosition);
     emit cursorPositionChanged(_cursorPosition);
 }
 
@@ -83,6 +81,8 @@ void Tg::LineEdit::setPlaceholderTextColor(const Tg::Color &placeholderTextColor
         return;
 
     _placeholderTextColor = placeholderTextColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::PlaceholderTextColor);
     emit placeholderTextColorChanged(_placeholderTextColor);
 }
 
@@ -92,70 +92,84 @@ void Tg::LineEdit::setPlaceholderBackgroundColor(const Tg::Color &placeholderBac
         return;
 
     _placeholderBackgroundColor = placeholderBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::PlaceholderBackgroundColor);
     emit placeholderBackgroundColorChanged(_placeholderBackgroundColor);
 }
 
+void Tg::LineEdit::applyStyleOverrides(Style *resolved) const
+{
+    Label::applyStyleOverrides(resolved);
+
+    if (_placeholderTextColor.isEmpty() == false) {
+        resolved->placeholderTextColor = _placeholderTextColor;
+    }
+
+    if (_placeholderBackgroundColor.isEmpty() == false) {
+        resolved->placeholderBackgroundColor = _placeholderBackgroundColor;
+    }
+}
+
+bool Tg::LineEdit::hasStyleOverrides() const
+{
+    return Label::hasStyleOverrides()
+            || _placeholderTextColor.isEmpty() == false
+            || _placeholderBackgroundColor.isEmpty() == false;
+}
+
 void Tg::LineEdit::init()
 {
     setAcceptsFocus(true);
     Label::init();
 
-    CHECK(connect(this, &LineEdit::placeholderTextChanged,
-                  this, &LineEdit::schedulePartialRedraw));
-    CHECK(connect(this, &LineEdit::placeholderTextColorChanged,
-                  this, &LineEdit::schedulePartialRedraw));
-    CHECK(connect(this, &LineEdit::placeholderBackgroundColorChanged,
-                  this, &LineEdit::schedulePartialRedraw));
-    CHECK(connect(this, &LineEdit::cursorPositionChanged,
-                  this, &LineEdit::schedulePartialRedraw));
-
     if (placeholderText().isEmpty() == false) {
         displayPlaceholderText();
     }
 }
 
-bool Tg::LineEdit::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::LineEdit::keyPressEvent(const KeyEvent &event)
 {
-    if (contentsRectangle().height() == 1) {
-        // Up Arrow
-        if (keyboardBuffer.contains(Tg::Key::up)) {
+    switch (event.key()) {
+    case Key::Code::Up:
+        if (contentsRectangle().height() == 1) {
             emit moveFocusToPreviousWidget();
             return true;
         }
-
-        // Down Arrow
-        if (keyboardBuffer.contains(Tg::Key::down)) {
+        // TODO: set cursor position up
+        return false;
+    case Key::Code::Down:
+        if (contentsRectangle().height() == 1) {
             emit moveFocusToNextWidget();
             return true;
         }
-    } else {
-        // TODO: set cursor position up/down
-    }
-
-    // Right Arrow
-    if (const QString command(Tg::Key::right);
-        keyboardBuffer.contains(command)) {
+        // TODO: set cursor position down
+        return false;
+    case Key::Code::Right:
         if (cursorPosition() < _realText.size()) {
-            setCursorPosition(cursorPosition() + 1);
+            // Cursor moves by whole grapheme clusters, it never ends up
+            // inside of a surrogate pair or before a combining mark
+            int position = cursorPosition();
+            for (int i = 0; i < event.count() && position < _realText.size(); ++i) {
+                position = Unicode::nextGraphemeBoundary(_realText, position);
+            }
+            setCursorPosition(position);
         }
         return true;
-    }
-
-    // Left Arrow
-    if (const QString command(Tg::Key::left);
-        keyboardBuffer.contains(command)) {
+    case Key::Code::Left:
         if (cursorPosition() > 0) {
-            setCursorPosition(cursorPosition() - 1);
+            int position = cursorPosition();
+            for (int i = 0; i < event.count() && position > 0; ++i) {
+                position = Unicode::previousGraphemeBoundary(_realText, position);
+            }
+            setCursorPosition(position);
         }
         return true;
-    }
-
-    // Backspace!
-    if (const QByteArray command(Tg::Key::backspace);
-        keyboardBuffer.contains(command)) {
+    case Key::Code::Backspace:
         if (_cursorPosition > 0) {
-            setCursorPosition(cursorPosition() - 1);
-            _realText.remove(cursorPosition(), 1);
+            const int position = Unicode::previousGraphemeBoundary(
+                        _realText, cursorPosition());
+            _realText.remove(position, cursorPosition() - position);
+            setCursorPosition(position);
             setText(_realText);
 
             if (_realText.isEmpty()) {
@@ -163,13 +177,11 @@ bool Tg::LineEdit::consumeKeyboardBuffer(const QString &keyboardBuffer)
             }
         }
         return true;
-    }
-
-    // Delete!
-    if (const QString command(Tg::Key::del);
-        keyboardBuffer.contains(command)) {
+    case Key::Code::Delete:
         if (_realText.isEmpty() == false) {
-            _realText.remove(cursorPosition(), 1);
+            _realText.remove(cursorPosition(),
+                             Unicode::nextGraphemeBoundary(_realText, cursorPosition())
+                             - cursorPosition());
             setText(_realText);
 
             if (_realText.isEmpty()) {
@@ -177,20 +189,43 @@ bool Tg::LineEdit::consumeKeyboardBuffer(const QString &keyboardBuffer)
             }
         }
         return true;
-    }
+    case Key::Code::Character:
+    case Key::Code::Space:
+        if (event.modifiers().testFlag(Key::Modifier::Ctrl)
+                || event.modifiers().testFlag(Key::Modifier::Alt)) {
+            return false;
+        }
 
-    if (_realText.isEmpty() && keyboardBuffer.isEmpty()) {
-        displayPlaceholderText();
-        return true;
-    } else {
-        _realText.insert(cursorPosition(), keyboardBuffer);
-        setText(_realText);
-        setCursorPosition(cursorPosition() + 1);
-        setTextColor(style()->textColor);
+        insertText(event.text());
         return true;
+    default:
+        return false;
+    }
+}
+
+bool Tg::LineEdit::pasteEvent(const PasteEvent &event)
+{
+    QString text = event.text();
+    if (contentsRectangle().height() == 1) {
+        text.replace(QLatin1Char('\n'), QLatin1Char(' '));
+    }
+
+    insertText(text);
+    return true;
+}
+
+void Tg::LineEdit::insertText(const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
     }
 
-    return false;
+    // Text is inserted with a single setText() call, so that even a long
+    // paste only triggers one relayout
+    _realText.insert(cursorPosition(), text);
+    setText(_realText);
+    setCursorPosition(cursorPosition() + text.size());
+    setTextColor(style()->textColor);
 }
 
 void Tg::LineEdit::displayPlaceholderText()
@@ -39,9 +39,26 @@ signals:
     void placeholderBackgroundColorChanged(const Tg::Color &placeholderBackgroundColor) const;
 
 protected:
+    /*!
+     * Properties of LineEdit, see Widget::PropertyId.
+     */
+    struct PropertyId : Label::PropertyId {
+        enum : int {
+            PlaceholderText = Label::PropertyId::Last,
+            PlaceholderTextColor,
+            PlaceholderBackgroundColor,
+            CursorPosition,
+            Last
+        };
+    };
+
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    void applyStyleOverrides(Style *resolved) const override;
+    bool hasStyleOverrides() const override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool pasteEvent(const PasteEvent &event) override;
 
+    void insertText(const QString &text);
     void displayPlaceholderText();
 
 private:
@@ -2,8 +2,12 @@
 #include "tgcheckbox.h"
 #include "styles/tgstyle.h"
 
+#include <tgunicode.h>
+
 #include <QRect>
 
+static_assert(sizeof(Tg::ListView) <= 376, "Tg::ListView has grown");
+
 Tg::ListView::ListView(Tg::Widget *parent) : Tg::ScrollArea(parent)
 {
     ListView::init();
@@ -51,13 +55,10 @@ QString Tg::ListView::drawAreaContents(const QPoint &pixel) const
 
     QString result = Tg::Color::code(textColor(), background);
 
-    const QString line(getLine(index));
-    if (childPx.x() >= (line.length() + offset)) {
+    updateCachedRow(childPx.y());
+    if (_rowCells.appendCell(childPx.x() - offset, &result) == false) {
         result.append(backgroundCharacter());
-        return result;
     }
-
-    result.append(line.at(childPx.x() - offset));
     return result;
 }
 
@@ -76,10 +77,23 @@ void Tg::ListView::setModel(QAbstractItemModel *model)
 
     CHECK(connect(_model, &QAbstractItemModel::dataChanged,
                   this, &ListView::schedulePartialRedraw));
+    CHECK(connect(_model, &QAbstractItemModel::dataChanged,
+                  this, &ListView::invalidateCachedRow));
+    CHECK(connect(_model, &QAbstractItemModel::rowsInserted,
+                  this, &ListView::invalidateCachedRow));
+    CHECK(connect(_model, &QAbstractItemModel::rowsRemoved,
+                  this, &ListView::invalidateCachedRow));
+    CHECK(connect(_model, &QAbstractItemModel::rowsMoved,
+                  this, &ListView::invalidateCachedRow));
+    CHECK(connect(_model, &QAbstractItemModel::layoutChanged,
+                  this, &ListView::invalidateCachedRow));
+    CHECK(connect(_model, &QAbstractItemModel::modelReset,
+                  this, &ListView::invalidateCachedRow));
 
     setCurrentIndex(0);
     updateChildrenDimensions();
 
+    propertyChanged(PropertyId::Model);
     emit modelChanged(model);
 }
 
@@ -95,11 +109,7 @@ bool Tg::ListView::alternatingRowColors() const
 
 Tg::Color Tg::ListView::alternativeBackgroundColor() const
 {
-    if (_alternativeBackgroundColor.isEmpty()) {
-        return style()->alternativeBackgroundColor;
-    } else {
-        return _alternativeBackgroundColor;
-    }
+    return resolvedStyle().alternativeBackgroundColor;
 }
 
 qsizetype Tg::ListView::currentIndex() const
@@ -109,11 +119,7 @@ qsizetype Tg::ListView::currentIndex() const
 
 Tg::Color Tg::ListView::currentIndexColor() const
 {
-    if (_currentIndexColor.isEmpty()) {
-        return style()->currentIndexColor;
-    } else {
-        return _currentIndexColor;
-    }
+    return resolvedStyle().currentIndexColor;
 }
 
 void Tg::ListView::setWrapRows(const bool wrapRows)
@@ -122,6 +128,7 @@ void Tg::ListView::setWrapRows(const bool wrapRows)
         return;
 
     _wrapRows = wrapRows;
+    propertyChanged(PropertyId::WrapRows);
     emit wrapRowsChanged(_wrapRows);
 }
 
@@ -131,6 +138,7 @@ void Tg::ListView::setAlternatingRowColors(const bool alternatingRowColors)
         return;
 
     _alternatingRowColors = alternatingRowColors;
+    propertyChanged(PropertyId::AlternatingRowColors);
     emit alternatingRowColorsChanged(_alternatingRowColors);
 }
 
@@ -140,6 +148,8 @@ void Tg::ListView::setAlternativeBackgroundColor(const Tg::Color &alternativeBac
         return;
 
     _alternativeBackgroundColor = alternativeBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::AlternativeBackgroundColor);
     emit alternativeBackgroundColorChanged(_alternativeBackgroundColor);
 }
 
@@ -149,6 +159,7 @@ void Tg::ListView::setCurrentIndex(const qsizetype currentIndex)
         return;
 
     _currentIndex = currentIndex;
+    propertyChanged(PropertyId::CurrentIndex);
     emit currentIndexChanged(_currentIndex);
 }
 
@@ -158,74 +169,93 @@ void Tg::ListView::setCurrentIndexColor(const Tg::Color &currentIndexColor)
         return;
 
     _currentIndexColor = currentIndexColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::CurrentIndexColor);
     emit currentIndexColorChanged(_currentIndexColor);
 }
 
+void Tg::ListView::applyStyleOverrides(Style *resolved) const
+{
+    ScrollArea::applyStyleOverrides(resolved);
+
+    if (_alternativeBackgroundColor.isEmpty() == false) {
+        resolved->alternativeBackgroundColor = _alternativeBackgroundColor;
+    }
+
+    if (_currentIndexColor.isEmpty() == false) {
+        resolved->currentIndexColor = _currentIndexColor;
+    }
+}
+
+bool Tg::ListView::hasStyleOverrides() const
+{
+    return ScrollArea::hasStyleOverrides()
+            || _alternativeBackgroundColor.isEmpty() == false
+            || _currentIndexColor.isEmpty() == false;
+}
+
 void Tg::ListView::init()
 {
     ScrollArea::init();
+}
 
-    CHECK(connect(this, &ListView::wrapRowsChanged,
-                  this, &ListView::schedulePartialRedraw));
-    CHECK(connect(this, &ListView::modelChanged,
-                  this, &ListView::schedulePartialRedraw));
-    CHECK(connect(this, &ListView::alternatingRowColorsChanged,
-                  this, &ListView::schedulePartialRedraw));
-    CHECK(connect(this, &ListView::alternativeBackgroundColorChanged,
-                  this, &ListView::schedulePartialRedraw));
-    CHECK(connect(this, &ListView::currentIndexChanged,
-                  this, &ListView::schedulePartialRedraw));
-    CHECK(connect(this, &ListView::currentIndexColorChanged,
-                  this, &ListView::schedulePartialRedraw));
+void Tg::ListView::propertyChanged(const int property)
+{
+    // Check box text of a row comes from the style
+    if (property == PropertyId::Model || property == PropertyId::Style) {
+        invalidateCachedRow();
+    }
+
+    ScrollArea::propertyChanged(property);
 }
 
-bool Tg::ListView::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::ListView::keyPressEvent(const KeyEvent &event)
 {
-    if (keyboardBuffer.contains(Tg::Key::right)
-            || keyboardBuffer.contains(Tg::Key::left)) {
-        return ScrollArea::consumeKeyboardBuffer(keyboardBuffer);
+    if (model() == nullptr) {
+        return ScrollArea::keyPressEvent(event);
     }
 
-    if (keyboardBuffer.contains(Tg::Key::down)) {
-        if ((currentIndex() + 1) < model()->rowCount()) {
-            setCurrentIndex(currentIndex() + 1);
-        }
+    switch (event.key()) {
+    case Key::Code::Right:
+    case Key::Code::Left:
+        return ScrollArea::keyPressEvent(event);
+    case Key::Code::Down: {
+        const qsizetype lastIndex = model()->rowCount() - 1;
+        const qsizetype index = std::min(currentIndex() + event.count(),
+                                         std::max(lastIndex, currentIndex()));
+        setCurrentIndex(index);
 
         const int currentY = contentsPosition().y();
         const int hiddenLength = std::abs(currentY);
         const int contentsHeight = scrollableArea().height();
         if (currentIndex() >= (hiddenLength + contentsHeight)) {
             QPoint pos = contentsPosition();
-            pos.setY(currentY - 1);
+            pos.setY(-int(currentIndex() - contentsHeight + 1));
             setContentsPosition(pos);
         }
 
         return true;
     }
-
-    if (keyboardBuffer.contains(Tg::Key::up)) {
-        if (currentIndex() > 0) {
-            setCurrentIndex(currentIndex() - 1);
-        }
+    case Key::Code::Up: {
+        const qsizetype index = std::max(currentIndex() - event.count(),
+                                         std::min(qsizetype(0), currentIndex()));
+        setCurrentIndex(index);
 
         const int currentY = contentsPosition().y();
         if (currentY < 0) {
             const int hiddenLength = std::abs(currentY);
             if (currentIndex() < hiddenLength) {
                 QPoint pos = contentsPosition();
-                pos.setY(currentY + 1);
+                pos.setY(-int(currentIndex()));
                 setContentsPosition(pos);
             }
         }
 
         return true;
     }
-
-    const bool select = keyboardBuffer.contains(Tg::Key::space);
-    const bool push = keyboardBuffer.contains(Tg::Key::enter)
-            || keyboardBuffer.contains(Tg::Key::ret);
-
-    if (select || push) {
+    case Key::Code::Space:
+    case Key::Code::Enter: {
+        const bool select = (event.key() == Key::Code::Space);
         const QModelIndex index = model()->index(currentIndex(), 0);
 
         if (select && model()->flags(index).testFlag(Qt::ItemFlag::ItemIsUserCheckable)) {
@@ -244,8 +274,9 @@ bool Tg::ListView::consumeKeyboardBuffer(const QString &keyboardBuffer)
             return true;
         }
     }
-
-    return false;
+    default:
+        return false;
+    }
 }
 
 QString Tg::ListView::getLine(const int row) const
@@ -301,7 +332,7 @@ void Tg::ListView::updateChildrenDimensions()
         }
 
         longestRowInView = std::max(longestRowInView,
-                                    qsizetype(line.length() + offset));
+                                    qsizetype(Unicode::width(line) + offset));
         // TODO: wrap support
     }
 
@@ -312,3 +343,15 @@ void Tg::ListView::updateChildrenDimensions()
         updateScrollBarStates();
     }
 }
+
+void Tg::ListView::updateCachedRow(const int row) const
+{
+    if (_rowCells.contains(row) == false) {
+        _rowCells.setLine(row, getLine(row));
+    }
+}
+
+void Tg::ListView::invalidateCachedRow()
+{
+    _rowCells.clear();
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <widgets/tgscrollarea.h>
+#include <utils/tglinecells.h>
 
 #include <QPointer>
 #include <QModelIndex>
@@ -49,8 +50,26 @@ signals:
     void indexPressed(const QModelIndex &index) const;
 
 protected:
+    /*!
+     * Properties of ListView, see Widget::PropertyId.
+     */
+    struct PropertyId : ScrollArea::PropertyId {
+        enum : int {
+            WrapRows = ScrollArea::PropertyId::Last,
+            Model,
+            AlternatingRowColors,
+            AlternativeBackgroundColor,
+            CurrentIndex,
+            CurrentIndexColor,
+            Last
+        };
+    };
+
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    void propertyChanged(const int property) override;
+    void applyStyleOverrides(Style *resolved) const override;
+    bool hasStyleOverrides() const override;
+    bool keyPressEvent(const KeyEvent &event) override;
     QString drawAreaContents(const QPoint &pixel) const override;
 
     QString getLine(const int row) const;
@@ -60,11 +79,17 @@ protected slots:
     void updateChildrenDimensions() override;
 
 private:
+    void updateCachedRow(const int row) const;
+    void invalidateCachedRow();
+
     QPointer<QAbstractItemModel> _model;
     bool _wrapRows = false;
     bool _alternatingRowColors = false;
     Tg::Color _alternativeBackgroundColor;
     Tg::Color _currentIndexColor;
     qsizetype _currentIndex = 0;
+
+    // Last drawn row
+    mutable LineCells _rowCells;
 };
 }
@@ -0,0 +1,268 @@
+#include "tglogview.h"
+
+#include <tgkey.h>
+#include <tgunicode.h>
+
+#include <QRect>
+
+static_assert(sizeof(Tg::LogView) <= 376, "Tg::LogView has grown");
+
+Tg::LogView::LogView(Tg::Widget *parent) : Tg::ScrollArea(parent)
+{
+    LogView::init();
+}
+
+Tg::LogView::LogView(Tg::Screen *screen) : Tg::ScrollArea(screen)
+{
+    LogView::init();
+}
+
+int Tg::LogView::maximumLineCount() const
+{
+    return _maximumLineCount;
+}
+
+bool Tg::LogView::followsTail() const
+{
+    return _followsTail;
+}
+
+int Tg::LogView::lineCount() const
+{
+    return _lineCount;
+}
+
+QString Tg::LogView::line(const int index) const
+{
+    if (index < 0 || index >= _lineCount) {
+        return {};
+    }
+
+    return _lines.at(storageIndex(index));
+}
+
+void Tg::LogView::appendText(const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    const int oldLineCount = _lineCount;
+    const int firstChangedLine = _isLastLineOpen? oldLineCount - 1
+                                                : oldLineCount;
+
+    const int size = int(text.size());
+    int droppedLineCount = 0;
+    int start = 0;
+    while (true) {
+        const int lineBreak = int(text.indexOf(QLatin1Char('\n'), start));
+        const int end = (lineBreak == -1)? size : lineBreak;
+        int length = end - start;
+        if (length > 0 && text.at(end - 1) == QLatin1Char('\r')) {
+            --length;
+        }
+
+        const QString part = text.mid(start, length);
+        if (_isLastLineOpen) {
+            continueLastLine(part);
+        } else if (lineBreak != -1 || part.isEmpty() == false) {
+            if (pushLine(part)) {
+                ++droppedLineCount;
+            }
+        }
+
+        if (lineBreak == -1) {
+            _isLastLineOpen = _isLastLineOpen || part.isEmpty() == false;
+            break;
+        }
+
+        _isLastLineOpen = false;
+        start = lineBreak + 1;
+    }
+
+    linesChanged(firstChangedLine, droppedLineCount);
+}
+
+void Tg::LogView::appendLine(const QString &line)
+{
+    // Unfinished line is closed first, so that line always starts a new one
+    _isLastLineOpen = false;
+
+    appendText(line + QLatin1Char('\n'));
+}
+
+void Tg::LogView::clear()
+{
+    _lines.clear();
+    _firstLine = 0;
+    _lineCount = 0;
+    _isLastLineOpen = false;
+    _longestLine = 0;
+    _lineCells.clear();
+
+    setContentsPosition(QPoint(0, 0));
+    updateChildrenDimensions();
+    schedulePartialRedraw();
+}
+
+void Tg::LogView::setMaximumLineCount(const int maximumLineCount)
+{
+    const int maximum = qMax(1, maximumLineCount);
+    if (_maximumLineCount == maximum)
+        return;
+
+    // Keep newest lines, in order, at the start of the new buffer
+    const int keptLineCount = qMin(_lineCount, maximum);
+    QVector<QString> lines;
+    lines.reserve(keptLineCount);
+    for (int i = _lineCount - keptLineCount; i < _lineCount; ++i) {
+        lines.append(_lines.at(storageIndex(i)));
+    }
+
+    _lines = lines;
+    _firstLine = 0;
+    _lineCount = keptLineCount;
+    _maximumLineCount = maximum;
+    _lineCells.clear();
+
+    updateChildrenDimensions();
+    propertyChanged(PropertyId::MaximumLineCount);
+    emit maximumLineCountChanged(_maximumLineCount);
+}
+
+void Tg::LogView::setFollowsTail(const bool followsTail)
+{
+    if (_followsTail == followsTail)
+        return;
+
+    _followsTail = followsTail;
+
+    if (_followsTail) {
+        const int lastTopLine = qMax(0, _lineCount - scrollableArea().height());
+        setContentsPosition(QPoint(contentsPosition().x(), -lastTopLine));
+    }
+
+    propertyChanged(PropertyId::FollowsTail);
+    emit followsTailChanged(_followsTail);
+}
+
+void Tg::LogView::init()
+{
+    ScrollArea::init();
+}
+
+bool Tg::LogView::keyPressEvent(const KeyEvent &event)
+{
+    const bool result = ScrollArea::keyPressEvent(event);
+    setFollowsTail(isAtBottom());
+    return result;
+}
+
+bool Tg::LogView::wheelEvent(const WheelEvent &event)
+{
+    const bool result = ScrollArea::wheelEvent(event);
+    setFollowsTail(isAtBottom());
+    return result;
+}
+
+QString Tg::LogView::drawAreaContents(const QPoint &pixel) const
+{
+    const QPoint childPx = childPixel(pixel);
+    if (childPx.y() < 0 || childPx.y() >= _lineCount) {
+        return {};
+    }
+
+    updateCachedLine(childPx.y());
+
+    QString result = Tg::Color::code(textColor(), backgroundColor());
+    if (_lineCells.appendCell(childPx.x(), &result) == false) {
+        result.append(backgroundCharacter());
+    }
+    return result;
+}
+
+void Tg::LogView::updateChildrenDimensions()
+{
+    setChildrenDimensions(_longestLine, _lineCount);
+}
+
+int Tg::LogView::storageIndex(const int index) const
+{
+    return (_firstLine + index) % int(_lines.size());
+}
+
+bool Tg::LogView::pushLine(const QString &line)
+{
+    _longestLine = qMax(_longestLine, Unicode::width(line));
+
+    if (_lines.size() < _maximumLineCount) {
+        _lines.append(line);
+        ++_lineCount;
+        return false;
+    }
+
+    // Buffer is full, overwrite the oldest line
+    _lines[_firstLine] = line;
+    _firstLine = (_firstLine + 1) % int(_lines.size());
+    return true;
+}
+
+void Tg::LogView::continueLastLine(const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    QString &last = _lines[storageIndex(_lineCount - 1)];
+    last.append(text);
+    _longestLine = qMax(_longestLine, Unicode::width(last));
+}
+
+void Tg::LogView::linesChanged(const int firstChangedLine,
+                               const int droppedLineCount)
+{
+    _lineCells.clear();
+    updateChildrenDimensions();
+
+    const int oldTop = firstVisibleRow();
+    int top = oldTop;
+    if (_followsTail) {
+        top = qMax(0, _lineCount - scrollableArea().height());
+    } else {
+        // Keep the same lines in view, unless they were dropped
+        top = qMax(0, oldTop - droppedLineCount);
+    }
+
+    if (top != oldTop) {
+        // Every row moves, whole Widget is redrawn
+        setContentsPosition(QPoint(contentsPosition().x(), -top));
+        return;
+    }
+
+    if (droppedLineCount > 0) {
+        schedulePartialRedraw();
+        return;
+    }
+
+    // Only rows from the first changed line down need a redraw
+    const QRect area = scrollableArea();
+    const int firstRow = qMax(0, firstChangedLine - top);
+    if (firstRow >= area.height()) {
+        return;
+    }
+
+    scheduleRectangleRedraw(QRect(area.x(), area.y() + firstRow,
+                                  area.width(), area.height() - firstRow));
+}
+
+bool Tg::LogView::isAtBottom() const
+{
+    return firstVisibleRow() >= (_lineCount - scrollableArea().height());
+}
+
+void Tg::LogView::updateCachedLine(const int index) const
+{
+    if (_lineCells.contains(index) == false) {
+        _lineCells.setLine(index, line(index));
+    }
+}
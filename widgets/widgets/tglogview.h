@@ -0,0 +1,127 @@
+#pragma once
+
+#include <widgets/tgscrollarea.h>
+#include <utils/tglinecells.h>
+
+#include <QString>
+#include <QVector>
+
+namespace Tg {
+/*!
+ * \brief Shows a stream of text, like output of a running process.
+ *
+ * LogView keeps at most maximumLineCount() lines in a ring buffer: when it is
+ * full, oldest lines are dropped. Appending text costs only as much as the
+ * appended text itself, no matter how much has been shown before, and only
+ * rows which changed are redrawn.
+ *
+ * Text can be appended in arbitrary chunks with appendText(), for example
+ * straight from QProcess::readyReadStandardOutput(): a line which is not
+ * finished with a line break is continued by the next chunk.
+ *
+ * While followsTail() is `true`, the view scrolls automatically to show the
+ * newest lines. Scrolling up turns it off, scrolling back to the bottom
+ * turns it on again.
+ *
+ * Lines are not wrapped, scroll horizontally to see the rest of long lines.
+ */
+class LogView : public ScrollArea
+{
+    Q_OBJECT
+
+    /*!
+     * Maximum number of lines kept by LogView. When more lines are appended,
+     * oldest ones are dropped.
+     */
+    Q_PROPERTY(int maximumLineCount READ maximumLineCount WRITE setMaximumLineCount NOTIFY maximumLineCountChanged)
+
+    /*!
+     * When `true`, the view scrolls to the last line whenever new text is
+     * appended.
+     */
+    Q_PROPERTY(bool followsTail READ followsTail WRITE setFollowsTail NOTIFY followsTailChanged)
+
+public:
+    LogView(Widget *parent);
+    LogView(Screen *screen);
+
+    int maximumLineCount() const;
+    bool followsTail() const;
+
+    int lineCount() const;
+
+    /*!
+     * Returns line number \a index, counting from the oldest line which is
+     * still kept.
+     */
+    QString line(const int index) const;
+
+public slots:
+    /*!
+     * Appends \a text to the log. Line breaks in \a text start new lines.
+     * If \a text does not end with a line break, its last line is continued
+     * by the next call.
+     */
+    void appendText(const QString &text);
+
+    /*!
+     * Appends \a line to the log, as a new line.
+     */
+    void appendLine(const QString &line);
+
+    void clear();
+
+    void setMaximumLineCount(const int maximumLineCount);
+    void setFollowsTail(const bool followsTail);
+
+signals:
+    void maximumLineCountChanged(const int maximumLineCount) const;
+    void followsTailChanged(const bool followsTail) const;
+
+protected:
+    /*!
+     * Properties of LogView, see Widget::PropertyId.
+     */
+    struct PropertyId : ScrollArea::PropertyId {
+        enum : int {
+            MaximumLineCount = ScrollArea::PropertyId::Last,
+            FollowsTail,
+            Last
+        };
+    };
+
+    void init() override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool wheelEvent(const WheelEvent &event) override;
+    QString drawAreaContents(const QPoint &pixel) const override;
+
+protected slots:
+    void updateChildrenDimensions() override;
+
+private:
+    int storageIndex(const int index) const;
+    /*!
+     * Appends \a line to the buffer. Returns `true` if the oldest line had
+     * to be dropped to make room for it.
+     */
+    bool pushLine(const QString &line);
+    void continueLastLine(const QString &text);
+    void linesChanged(const int firstChangedLine, const int droppedLineCount);
+    bool isAtBottom() const;
+    void updateCachedLine(const int index) const;
+
+    // Ring buffer. It grows up to _maximumLineCount entries, then the oldest
+    // entry (at _firstLine) is overwritten by each new line
+    QVector<QString> _lines;
+    int _firstLine = 0;
+    int _lineCount = 0;
+    int _maximumLineCount = 10000;
+    bool _isLastLineOpen = false;
+    int _longestLine = 0;
+
+    bool _followsTail = true;
+
+    // Last drawn line
+    mutable LineCells _lineCells;
+};
+}
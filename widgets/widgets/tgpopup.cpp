@@ -2,6 +2,8 @@
 
 #include "tgscreen.h"
 
+static_assert(sizeof(Tg::Popup) <= 208, "Tg::Popup has grown");
+
 Tg::Popup::Popup(const QSize &size, Screen *parent) : Widget(parent)
 {
     setSize(size);
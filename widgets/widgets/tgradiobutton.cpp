@@ -56,6 +56,8 @@ void Tg::ExclusiveGroup::onRadioButtonCheckedChanged(const bool checked)
     }
 }
 
+static_assert(sizeof(Tg::RadioButton) <= 472, "Tg::RadioButton has grown");
+
 Tg::RadioButton::RadioButton(Tg::Widget *parent) : Tg::Button(parent)
 {
     RadioButton::init();
@@ -138,24 +140,24 @@ void Tg::RadioButton::init()
                   this, &RadioButton::toggleState));
 }
 
-bool Tg::RadioButton::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::RadioButton::keyPressEvent(const KeyEvent &event)
 {
-    if (keyboardBuffer.contains(Tg::Key::space)) {
+    if (event.key() == Key::Code::Space) {
         setTextColor(pressedTextColor());
         setBackgroundColor(pressedBackgroundColor());
         emit clicked();
         return true;
     }
 
-    return Button::consumeKeyboardBuffer(keyboardBuffer);
+    return Button::keyPressEvent(event);
 }
 
 QString Tg::RadioButton::radioButtonText() const
 {
     if (checked()) {
-        return style()->radioButtonChecked;
+        return resolvedStyle().radioButtonChecked;
     } else {
-        return style()->radioButtonUnChecked;
+        return resolvedStyle().radioButtonUnChecked;
     }
 }
 
@@ -55,7 +55,7 @@ signals:
 
 protected:
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    bool keyPressEvent(const KeyEvent &event) override;
     QString radioButtonText() const;
 
 private:
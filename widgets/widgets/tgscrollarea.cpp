@@ -4,6 +4,9 @@
 #include <tgkey.h>
 
 #include <QRect>
+#include <QTimer>
+
+static_assert(sizeof(Tg::ScrollArea) <= 272, "Tg::ScrollArea has grown");
 
 Tg::ScrollArea::ScrollArea(Tg::Widget *parent) : Tg::Widget(parent)
 {
@@ -63,7 +66,7 @@ QString Tg::ScrollArea::drawPixel(const QPoint &pixel) const
 
 QString Tg::ScrollArea::drawAreaContents(const QPoint &pixel) const
 {
-    const auto children = childrenWidgets();
+    const auto &children = childrenWidgets();
     const WidgetPointer widget = Helpers::topWidget(children, pixel, WidgetType::All);
     if (widget.isNull() == false
             && widget->visible()
@@ -89,91 +92,111 @@ void Tg::ScrollArea::setContentsPosition(const QPoint &contentsPosition)
 
     _contentsPosition = contentsPosition;
     updateScrollBarPositions();
+    propertyChanged(PropertyId::ContentsPosition);
     emit contentsPositionChanged(_contentsPosition);
 }
 
 void Tg::ScrollArea::init()
 {
-    _verticalScrollBar = new ScrollBar(this);
-    _verticalScrollBar->setOrientation(Qt::Orientation::Vertical);
-    _verticalScrollBar->setAcceptsFocus(false);
+    // Subclasses run this again, see Widget::init()
+    const bool isInitialized = _verticalScrollBar.isNull() == false;
+
+    if (isInitialized == false) {
+        _verticalScrollBar = new ScrollBar(this);
+        _verticalScrollBar->setOrientation(Qt::Orientation::Vertical);
+        _verticalScrollBar->setAcceptsFocus(false);
 
-    _horizontalScrollBar = new ScrollBar(this);
-    _horizontalScrollBar->setOrientation(Qt::Orientation::Horizontal);
-    _horizontalScrollBar->setAcceptsFocus(false);
+        _horizontalScrollBar = new ScrollBar(this);
+        _horizontalScrollBar->setOrientation(Qt::Orientation::Horizontal);
+        _horizontalScrollBar->setAcceptsFocus(false);
+    }
 
     setAcceptsFocus(true);
 
     Widget::init();
 
-    CHECK(connect(this, &ScrollArea::contentsPositionChanged,
-                  this, &ScrollArea::schedulePartialRedraw));
-
-    CHECK(connect(this, &ScrollArea::childAdded,
-                  this, &ScrollArea::connectChild));
-    CHECK(connect(this, &ScrollArea::childAdded,
-                  this, &ScrollArea::updateChildrenDimensions));
-    CHECK(connect(this, &ScrollArea::childRemoved,
-                  this, &ScrollArea::updateChildrenDimensions));
+    if (isInitialized == false) {
+        CHECK(connect(this, &ScrollArea::childAdded,
+                      this, &ScrollArea::connectChild));
+        CHECK(connect(this, &ScrollArea::childAdded,
+                      this, &ScrollArea::updateChildrenDimensions));
+        CHECK(connect(this, &ScrollArea::childRemoved,
+                      this, &ScrollArea::updateChildrenDimensions));
+    }
 
     QTimer::singleShot(1, this, [=](){
         updateChildrenDimensions();
     });
 }
 
-bool Tg::ScrollArea::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::ScrollArea::keyPressEvent(const KeyEvent &event)
 {
-    if (keyboardBuffer.contains(Tg::Key::right)) {
+    switch (event.key()) {
+    case Key::Code::Right: {
         const int currentX = contentsPosition().x();
-        const int hiddenLength = std::abs(currentX);
-        const int contentsWidth = scrollableArea().width();
-        const int childrenW = childrenWidth();
-        if ((hiddenLength + contentsWidth) < childrenW) {
+        const int hiddenLimit = childrenWidth() - scrollableArea().width();
+        const int newX = std::max(currentX - event.count(),
+                                  std::min(currentX, -hiddenLimit));
+        if (newX != currentX) {
             QPoint pos = contentsPosition();
-            pos.setX(currentX - 1);
+            pos.setX(newX);
             setContentsPosition(pos);
         }
 
         return true;
     }
-
-    if (keyboardBuffer.contains(Tg::Key::left)) {
+    case Key::Code::Left: {
         const int currentX = contentsPosition().x();
         if (currentX < 0) {
             QPoint pos = contentsPosition();
-            pos.setX(currentX + 1);
+            pos.setX(std::min(0, currentX + event.count()));
             setContentsPosition(pos);
         }
 
         return true;
     }
-
-    if (keyboardBuffer.contains(Tg::Key::down)) {
+    case Key::Code::Down: {
         const int currentY = contentsPosition().y();
-        const int hiddenLength = std::abs(currentY);
-        const int contentsHeight = scrollableArea().height();
-        const int childrenH = childrenHeight();
-        if ((hiddenLength + contentsHeight) < childrenH) {
+        const int hiddenLimit = childrenHeight() - scrollableArea().height();
+        const int newY = std::max(currentY - event.count(),
+                                  std::min(currentY, -hiddenLimit));
+        if (newY != currentY) {
             QPoint pos = contentsPosition();
-            pos.setY(currentY - 1);
+            pos.setY(newY);
             setContentsPosition(pos);
         }
 
         return true;
     }
-
-    if (keyboardBuffer.contains(Tg::Key::up)) {
+    case Key::Code::Up: {
         const int currentY = contentsPosition().y();
         if (currentY < 0) {
             QPoint pos = contentsPosition();
-            pos.setY(currentY + 1);
+            pos.setY(std::min(0, currentY + event.count()));
             setContentsPosition(pos);
         }
 
         return true;
     }
+    default:
+        return false;
+    }
+}
 
-    return false;
+bool Tg::ScrollArea::wheelEvent(const WheelEvent &event)
+{
+    const int currentY = contentsPosition().y();
+    const int hiddenLimit = childrenHeight() - scrollableArea().height();
+    const int newY = std::min(0, std::max(currentY + event.delta(),
+                                          -std::max(0, hiddenLimit)));
+
+    if (newY != currentY) {
+        QPoint pos = contentsPosition();
+        pos.setY(newY);
+        setContentsPosition(pos);
+    }
+
+    return true;
 }
 
 void Tg::ScrollArea::updateChildrenDimensions()
@@ -230,6 +253,22 @@ int Tg::ScrollArea::childrenHeight() const
     return _childrenHeight;
 }
 
+void Tg::ScrollArea::setChildrenDimensions(const int width, const int height)
+{
+    if (_childrenWidth == width && _childrenHeight == height) {
+        return;
+    }
+
+    _childrenWidth = width;
+    _childrenHeight = height;
+    updateScrollBarStates();
+}
+
+int Tg::ScrollArea::firstVisibleRow() const
+{
+    return -contentsPosition().y();
+}
+
 QRect Tg::ScrollArea::scrollableArea() const
 {
     QRect result = contentsRectangle();
@@ -43,8 +43,19 @@ signals:
     void horizontalScrollBarPolicyChanged(const ScrollBarPolicy newPolicy) const;
 
 protected:
+    /*!
+     * Properties of ScrollArea, see Widget::PropertyId.
+     */
+    struct PropertyId : Widget::PropertyId {
+        enum : int {
+            ContentsPosition = Widget::PropertyId::Last,
+            Last
+        };
+    };
+
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool wheelEvent(const WheelEvent &event) override;
     QString drawPixel(const QPoint &pixel) const override;
     virtual QString drawAreaContents(const QPoint &pixel) const;
 
@@ -54,6 +65,18 @@ protected:
     int childrenHeight() const;
     QRect scrollableArea() const;
 
+    /*!
+     * Sets childrenWidth() and childrenHeight(), and updates scroll bars if
+     * they changed. Subclasses which draw their contents themselves call it
+     * from updateChildrenDimensions().
+     */
+    void setChildrenDimensions(const int width, const int height);
+
+    /*!
+     * Returns index of the first row of contents shown in scrollableArea().
+     */
+    int firstVisibleRow() const;
+
     void updateScrollBarStates();
     void updateScrollBarPositions();
 
@@ -3,6 +3,8 @@
 
 #include <math.h>
 
+static_assert(sizeof(Tg::ScrollBar) <= 512, "Tg::ScrollBar has grown");
+
 Tg::ScrollBar::ScrollBar(Tg::Widget *parent) : Tg::Widget(parent)
 {
     ScrollBar::init();
@@ -73,209 +75,117 @@ int Tg::ScrollBar::sliderPosition() const
 
 QString Tg::ScrollBar::sliderCharacter() const
 {
-    if (_sliderCharacter.isNull()) {
-        return style()->sliderCharacter;
-    } else {
-        return _sliderCharacter;
-    }
+    return resolvedStyle().sliderCharacter;
 }
 
 Tg::Color Tg::ScrollBar::sliderColor() const
 {
-    if (_sliderColor.isEmpty()) {
-        return style()->sliderColor;
-    } else {
-        return _sliderColor;
-    }
+    return resolvedStyle().sliderColor;
 }
 
 Tg::Color Tg::ScrollBar::sliderBackgroundColor() const
 {
-    if (_sliderBackgroundColor.isEmpty()) {
-        return style()->sliderBackgroundColor;
-    } else {
-        return _sliderBackgroundColor;
-    }
+    return resolvedStyle().sliderBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::sliderActiveBackgroundColor() const
 {
-    if (_sliderActiveBackgroundColor.isEmpty()) {
-        return style()->sliderActiveBackgroundColor;
-    } else {
-        return _sliderActiveBackgroundColor;
-    }
+    return resolvedStyle().sliderActiveBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::sliderInactiveBackgroundColor() const
 {
-    if (_sliderInactiveBackgroundColor.isEmpty()) {
-        return style()->sliderInactiveBackgroundColor;
-    } else {
-        return _sliderInactiveBackgroundColor;
-    }
+    return resolvedStyle().sliderInactiveBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::sliderActiveColor() const
 {
-    if (_sliderActiveColor.isEmpty()) {
-        return style()->sliderActiveColor;
-    } else {
-        return _sliderActiveColor;
-    }
+    return resolvedStyle().sliderActiveColor;
 }
 
 Tg::Color Tg::ScrollBar::sliderInactiveColor() const
 {
-    if (_sliderInactiveColor.isEmpty()) {
-        return style()->sliderInactiveColor;
-    } else {
-        return _sliderInactiveColor;
-    }
+    return resolvedStyle().sliderInactiveColor;
 }
 
 QString Tg::ScrollBar::backwardArrowUpCharacter() const
 {
-    if (_backwardArrowUpCharacter.isNull()) {
-        return style()->backwardArrowUpCharacter;
-    } else {
-        return _backwardArrowUpCharacter;
-    }
+    return resolvedStyle().backwardArrowUpCharacter;
 }
 
 QString Tg::ScrollBar::backwardArrowLeftCharacter() const
 {
-    if (_backwardArrowLeftCharacter.isNull()) {
-        return style()->backwardArrowLeftCharacter;
-    } else {
-        return _backwardArrowLeftCharacter;
-    }
+    return resolvedStyle().backwardArrowLeftCharacter;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowColor() const
 {
-    if (_backwardArrowColor.isEmpty()) {
-        return style()->backwardArrowColor;
-    } else {
-        return _backwardArrowColor;
-    }
+    return resolvedStyle().backwardArrowColor;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowActiveColor() const
 {
-    if (_backwardArrowActiveColor.isEmpty()) {
-        return style()->backwardArrowActiveColor;
-    } else {
-        return _backwardArrowActiveColor;
-    }
+    return resolvedStyle().backwardArrowActiveColor;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowInactiveColor() const
 {
-    if (_backwardArrowInactiveColor.isEmpty()) {
-        return style()->backwardArrowInactiveColor;
-    } else {
-        return _backwardArrowInactiveColor;
-    }
+    return resolvedStyle().backwardArrowInactiveColor;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowBackgroundColor() const
 {
-    if (_backwardArrowBackgroundColor.isEmpty()) {
-        return style()->backwardArrowBackgroundColor;
-    } else {
-        return _backwardArrowBackgroundColor;
-    }
+    return resolvedStyle().backwardArrowBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowActiveBackgroundColor() const
 {
-    if (_backwardArrowActiveBackgroundColor.isEmpty()) {
-        return style()->backwardArrowActiveBackgroundColor;
-    } else {
-        return _backwardArrowActiveBackgroundColor;
-    }
+    return resolvedStyle().backwardArrowActiveBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::backwardArrowInactiveBackgroundColor() const
 {
-    if (_backwardArrowInactiveBackgroundColor.isEmpty()) {
-        return style()->backwardArrowInactiveBackgroundColor;
-    } else {
-        return _backwardArrowInactiveBackgroundColor;
-    }
+    return resolvedStyle().backwardArrowInactiveBackgroundColor;
 }
 
 QString Tg::ScrollBar::forwardArrowDownCharacter() const
 {
-    if (_forwardArrowDownCharacter.isNull()) {
-        return style()->forwardArrowDownCharacter;
-    } else {
-        return _forwardArrowDownCharacter;
-    }
+    return resolvedStyle().forwardArrowDownCharacter;
 }
 
 QString Tg::ScrollBar::forwardArrowRightCharacter() const
 {
-    if (_forwardArrowRightCharacter.isNull()) {
-        return style()->forwardArrowRightCharacter;
-    } else {
-        return _forwardArrowRightCharacter;
-    }
+    return resolvedStyle().forwardArrowRightCharacter;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowColor() const
 {
-    if (_forwardArrowColor.isEmpty()) {
-        return style()->forwardArrowColor;
-    } else {
-        return _forwardArrowColor;
-    }
+    return resolvedStyle().forwardArrowColor;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowActiveColor() const
 {
-    if (_forwardArrowActiveColor.isEmpty()) {
-        return style()->forwardArrowActiveColor;
-    } else {
-        return _forwardArrowActiveColor;
-    }
+    return resolvedStyle().forwardArrowActiveColor;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowInactiveColor() const
 {
-    if (_forwardArrowInactiveColor.isEmpty()) {
-        return style()->forwardArrowInactiveColor;
-    } else {
-        return _forwardArrowInactiveColor;
-    }
+    return resolvedStyle().forwardArrowInactiveColor;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowBackgroundColor() const
 {
-    if (_forwardArrowBackgroundColor.isEmpty()) {
-        return style()->forwardArrowBackgroundColor;
-    } else {
-        return _forwardArrowBackgroundColor;
-    }
+    return resolvedStyle().forwardArrowBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowActiveBackgroundColor() const
 {
-    if (_forwardArrowActiveBackgroundColor.isEmpty()) {
-        return style()->forwardArrowActiveBackgroundColor;
-    } else {
-        return _forwardArrowActiveBackgroundColor;
-    }
+    return resolvedStyle().forwardArrowActiveBackgroundColor;
 }
 
 Tg::Color Tg::ScrollBar::forwardArrowInactiveBackgroundColor() const
 {
-    if (_forwardArrowInactiveBackgroundColor.isEmpty()) {
-        return style()->forwardArrowInactiveBackgroundColor;
-    } else {
-        return _forwardArrowInactiveBackgroundColor;
-    }
+    return resolvedStyle().forwardArrowInactiveBackgroundColor;
 }
 
 void Tg::ScrollBar::setOrientation(const Qt::Orientation orientation)
@@ -284,6 +194,7 @@ void Tg::ScrollBar::setOrientation(const Qt::Orientation orientation)
         return;
 
     _orientation = orientation;
+    propertyChanged(PropertyId::Orientation);
     emit orientationChanged(_orientation);
 }
 
@@ -293,6 +204,7 @@ void Tg::ScrollBar::setMinimum(const int minimum)
         return;
 
     _minimum = minimum;
+    propertyChanged(PropertyId::Minimum);
     emit minimumChanged(_minimum);
 }
 
@@ -302,6 +214,7 @@ void Tg::ScrollBar::setMaximum(const int maximum)
         return;
 
     _maximum = maximum;
+    propertyChanged(PropertyId::Maximum);
     emit maximumChanged(_maximum);
 }
 
@@ -316,6 +229,7 @@ void Tg::ScrollBar::setSliderPosition(const int sliderPosition)
         return;
 
     _sliderPosition = sliderPosition;
+    propertyChanged(PropertyId::SliderPosition);
     emit sliderPositionChanged(_sliderPosition);
 }
 
@@ -325,6 +239,8 @@ void Tg::ScrollBar::setSliderCharacter(const QString &sliderCharacter)
         return;
 
     _sliderCharacter = sliderCharacter;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::SliderCharacter);
     emit sliderCharacterChanged(_sliderCharacter);
 }
 
@@ -334,6 +250,8 @@ void Tg::ScrollBar::setSliderColor(const Tg::Color &sliderColor)
         return;
 
     _sliderColor = sliderColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::SliderColor);
     emit sliderColorChanged(_sliderColor);
 }
 
@@ -343,6 +261,8 @@ void Tg::ScrollBar::setSliderBackgroundColor(const Tg::Color &sliderBackgroundCo
         return;
 
     _sliderBackgroundColor = sliderBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::SliderBackgroundColor);
     emit sliderBackgroundColorChanged(_sliderBackgroundColor);
 }
 
@@ -352,6 +272,7 @@ void Tg::ScrollBar::setSliderActiveBackgroundColor(const Tg::Color &sliderActive
         return;
 
     _sliderActiveBackgroundColor = sliderActiveBackgroundColor;
+    updateResolvedStyle();
     emit sliderActiveBackgroundColorChanged(_sliderActiveBackgroundColor);
 }
 
@@ -361,6 +282,7 @@ void Tg::ScrollBar::setSliderInactiveBackgroundColor(const Tg::Color &sliderInac
         return;
 
     _sliderInactiveBackgroundColor = sliderInactiveBackgroundColor;
+    updateResolvedStyle();
     emit sliderInactiveBackgroundColorChanged(_sliderInactiveBackgroundColor);
 }
 
@@ -370,6 +292,8 @@ void Tg::ScrollBar::setSliderActiveColor(const Tg::Color &sliderActiveColor)
         return;
 
     _sliderActiveColor = sliderActiveColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::SliderActiveColor);
     emit sliderActiveColorChanged(_sliderActiveColor);
 }
 
@@ -379,6 +303,7 @@ void Tg::ScrollBar::setSliderInactiveColor(const Tg::Color &sliderInactiveColor)
         return;
 
     _sliderInactiveColor = sliderInactiveColor;
+    updateResolvedStyle();
     emit sliderInactiveColorChanged(_sliderInactiveColor);
 }
 
@@ -388,6 +313,8 @@ void Tg::ScrollBar::setBackwardArrowUpCharacter(const QString &backwardArrowUpCh
         return;
 
     _backwardArrowUpCharacter = backwardArrowUpCharacter;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowUpCharacter);
     emit backwardArrowUpCharacterChanged(_backwardArrowUpCharacter);
 }
 
@@ -397,6 +324,8 @@ void Tg::ScrollBar::setBackwardArrowLeftCharacter(const QString &backwardArrowLe
         return;
 
     _backwardArrowLeftCharacter = backwardArrowLeftCharacter;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowLeftCharacter);
     emit backwardArrowLeftCharacterChanged(_backwardArrowLeftCharacter);
 }
 
@@ -406,6 +335,8 @@ void Tg::ScrollBar::setBackwardArrowColor(const Tg::Color &backwardArrowColor)
         return;
 
     _backwardArrowColor = backwardArrowColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowColor);
     emit backwardArrowColorChanged(_backwardArrowColor);
 }
 
@@ -415,6 +346,8 @@ void Tg::ScrollBar::setBackwardArrowActiveColor(const Tg::Color &backwardArrowAc
         return;
 
     _backwardArrowActiveColor = backwardArrowActiveColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowActiveColor);
     emit backwardArrowActiveColorChanged(_backwardArrowActiveColor);
 }
 
@@ -424,6 +357,8 @@ void Tg::ScrollBar::setBackwardArrowInactiveColor(const Tg::Color &backwardArrow
         return;
 
     _backwardArrowInactiveColor = backwardArrowInactiveColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowInactiveColor);
     emit backwardArrowInactiveColorChanged(_backwardArrowInactiveColor);
 }
 
@@ -433,6 +368,8 @@ void Tg::ScrollBar::setBackwardArrowBackgroundColor(const Tg::Color &backwardArr
         return;
 
     _backwardArrowBackgroundColor = backwardArrowBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowColorBackground);
     emit backwardArrowColorBackgroundChanged(_backwardArrowBackgroundColor);
 }
 
@@ -442,6 +379,8 @@ void Tg::ScrollBar::setBackwardArrowActiveBackgroundColor(const Tg::Color &backw
         return;
 
     _backwardArrowActiveBackgroundColor = backwardArrowActiveBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowActiveColorBackground);
     emit backwardArrowActiveColorBackgroundChanged(_backwardArrowActiveBackgroundColor);
 }
 
@@ -451,6 +390,8 @@ void Tg::ScrollBar::setBackwardArrowInactiveBackgroundColor(const Tg::Color &bac
         return;
 
     _backwardArrowInactiveBackgroundColor = backwardArrowInactiveBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackwardArrowInactiveColorBackground);
     emit backwardArrowInactiveColorBackgroundChanged(_backwardArrowInactiveBackgroundColor);
 }
 
@@ -460,6 +401,8 @@ void Tg::ScrollBar::setForwardArrowDownCharacter(const QString &forwardArrowDown
         return;
 
     _forwardArrowDownCharacter = forwardArrowDownCharacter;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowDownCharacter);
     emit forwardArrowDownCharacterChanged(_forwardArrowDownCharacter);
 }
 
@@ -469,6 +412,8 @@ void Tg::ScrollBar::setForwardArrowRightCharacter(const QString &forwardArrowRig
         return;
 
     _forwardArrowRightCharacter = forwardArrowRightCharacter;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowRightCharacter);
     emit forwardArrowRightCharacterChanged(_forwardArrowRightCharacter);
 }
 
@@ -478,6 +423,8 @@ void Tg::ScrollBar::setForwardArrowColor(const Tg::Color &forwardArrowColor)
         return;
 
     _forwardArrowColor = forwardArrowColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowColor);
     emit forwardArrowColorChanged(_forwardArrowColor);
 }
 
@@ -487,6 +434,8 @@ void Tg::ScrollBar::setForwardArrowActiveColor(const Tg::Color &forwardArrowActi
         return;
 
     _forwardArrowActiveColor = forwardArrowActiveColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowActiveColor);
     emit forwardArrowActiveColorChanged(_forwardArrowActiveColor);
 }
 
@@ -496,6 +445,8 @@ void Tg::ScrollBar::setForwardArrowInactiveColor(const Tg::Color &forwardArrowIn
         return;
 
     _forwardArrowInactiveColor = forwardArrowInactiveColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowInactiveColor);
     emit forwardArrowInactiveColorChanged(_forwardArrowInactiveColor);
 }
 
@@ -505,6 +456,8 @@ void Tg::ScrollBar::setForwardArrowBackgroundColor(const Tg::Color &forwardArrow
         return;
 
     _forwardArrowBackgroundColor = forwardArrowBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowColorBackground);
     emit forwardArrowColorBackgroundChanged(_forwardArrowBackgroundColor);
 }
 
@@ -514,6 +467,8 @@ void Tg::ScrollBar::setForwardArrowActiveBackgroundColor(const Tg::Color &forwar
         return;
 
     _forwardArrowActiveBackgroundColor = forwardArrowActiveBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowActiveColorBackground);
     emit forwardArrowActiveColorBackgroundChanged(_forwardArrowActiveBackgroundColor);
 }
 
@@ -523,6 +478,8 @@ void Tg::ScrollBar::setForwardArrowInactiveBackgroundColor(const Tg::Color &forw
         return;
 
     _forwardArrowInactiveBackgroundColor = forwardArrowInactiveBackgroundColor;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::ForwardArrowInactiveColorBackground);
     emit forwardArrowInactiveColorBackgroundChanged(_forwardArrowInactiveBackgroundColor);
 }
 
@@ -531,110 +488,191 @@ void Tg::ScrollBar::enforceProperSize()
     // nothing, for now
 }
 
+void Tg::ScrollBar::applyStyleOverrides(Style *resolved) const
+{
+    Widget::applyStyleOverrides(resolved);
+
+    if (_sliderCharacter.isNull() == false) {
+        resolved->sliderCharacter = _sliderCharacter;
+    }
+
+    if (_sliderColor.isEmpty() == false) {
+        resolved->sliderColor = _sliderColor;
+    }
+
+    if (_sliderBackgroundColor.isEmpty() == false) {
+        resolved->sliderBackgroundColor = _sliderBackgroundColor;
+    }
+
+    if (_sliderActiveBackgroundColor.isEmpty() == false) {
+        resolved->sliderActiveBackgroundColor = _sliderActiveBackgroundColor;
+    }
+
+    if (_sliderInactiveBackgroundColor.isEmpty() == false) {
+        resolved->sliderInactiveBackgroundColor = _sliderInactiveBackgroundColor;
+    }
+
+    if (_sliderActiveColor.isEmpty() == false) {
+        resolved->sliderActiveColor = _sliderActiveColor;
+    }
+
+    if (_sliderInactiveColor.isEmpty() == false) {
+        resolved->sliderInactiveColor = _sliderInactiveColor;
+    }
+
+    if (_backwardArrowUpCharacter.isNull() == false) {
+        resolved->backwardArrowUpCharacter = _backwardArrowUpCharacter;
+    }
+
+    if (_backwardArrowLeftCharacter.isNull() == false) {
+        resolved->backwardArrowLeftCharacter = _backwardArrowLeftCharacter;
+    }
+
+    if (_backwardArrowColor.isEmpty() == false) {
+        resolved->backwardArrowColor = _backwardArrowColor;
+    }
+
+    if (_backwardArrowActiveColor.isEmpty() == false) {
+        resolved->backwardArrowActiveColor = _backwardArrowActiveColor;
+    }
+
+    if (_backwardArrowInactiveColor.isEmpty() == false) {
+        resolved->backwardArrowInactiveColor = _backwardArrowInactiveColor;
+    }
+
+    if (_backwardArrowBackgroundColor.isEmpty() == false) {
+        resolved->backwardArrowBackgroundColor = _backwardArrowBackgroundColor;
+    }
+
+    if (_backwardArrowActiveBackgroundColor.isEmpty() == false) {
+        resolved->backwardArrowActiveBackgroundColor = _backwardArrowActiveBackgroundColor;
+    }
+
+    if (_backwardArrowInactiveBackgroundColor.isEmpty() == false) {
+        resolved->backwardArrowInactiveBackgroundColor = _backwardArrowInactiveBackgroundColor;
+    }
+
+    if (_forwardArrowDownCharacter.isNull() == false) {
+        resolved->forwardArrowDownCharacter = _forwardArrowDownCharacter;
+    }
+
+    if (_forwardArrowRightCharacter.isNull() == false) {
+        resolved->forwardArrowRightCharacter = _forwardArrowRightCharacter;
+    }
+
+    if (_forwardArrowColor.isEmpty() == false) {
+        resolved->forwardArrowColor = _forwardArrowColor;
+    }
+
+    if (_forwardArrowActiveColor.isEmpty() == false) {
+        resolved->forwardArrowActiveColor = _forwardArrowActiveColor;
+    }
+
+    if (_forwardArrowInactiveColor.isEmpty() == false) {
+        resolved->forwardArrowInactiveColor = _forwardArrowInactiveColor;
+    }
+
+    if (_forwardArrowBackgroundColor.isEmpty() == false) {
+        resolved->forwardArrowBackgroundColor = _forwardArrowBackgroundColor;
+    }
+
+    if (_forwardArrowActiveBackgroundColor.isEmpty() == false) {
+        resolved->forwardArrowActiveBackgroundColor = _forwardArrowActiveBackgroundColor;
+    }
+
+    if (_forwardArrowInactiveBackgroundColor.isEmpty() == false) {
+        resolved->forwardArrowInactiveBackgroundColor = _forwardArrowInactiveBackgroundColor;
+    }
+}
+
+bool Tg::ScrollBar::hasStyleOverrides() const
+{
+    return Widget::hasStyleOverrides()
+            || _sliderCharacter.isNull() == false
+            || _sliderColor.isEmpty() == false
+            || _sliderBackgroundColor.isEmpty() == false
+            || _sliderActiveBackgroundColor.isEmpty() == false
+            || _sliderInactiveBackgroundColor.isEmpty() == false
+            || _sliderActiveColor.isEmpty() == false
+            || _sliderInactiveColor.isEmpty() == false
+            || _backwardArrowUpCharacter.isNull() == false
+            || _backwardArrowLeftCharacter.isNull() == false
+            || _backwardArrowColor.isEmpty() == false
+            || _backwardArrowActiveColor.isEmpty() == false
+            || _backwardArrowInactiveColor.isEmpty() == false
+            || _backwardArrowBackgroundColor.isEmpty() == false
+            || _backwardArrowActiveBackgroundColor.isEmpty() == false
+            || _backwardArrowInactiveBackgroundColor.isEmpty() == false
+            || _forwardArrowDownCharacter.isNull() == false
+            || _forwardArrowRightCharacter.isNull() == false
+            || _forwardArrowColor.isEmpty() == false
+            || _forwardArrowActiveColor.isEmpty() == false
+            || _forwardArrowInactiveColor.isEmpty() == false
+            || _forwardArrowBackgroundColor.isEmpty() == false
+            || _forwardArrowActiveBackgroundColor.isEmpty() == false
+            || _forwardArrowInactiveBackgroundColor.isEmpty() == false;
+}
+
+void Tg::ScrollBar::propertyChanged(const int property)
+{
+    Widget::propertyChanged(property);
+
+    if (property == PropertyId::SliderPosition) {
+        restartTimer(_sliderPressTimer);
+    }
+}
+
 void Tg::ScrollBar::init()
 {
     setAcceptsFocus(true);
 
     Widget::init();
 
-    // TODO: move these connects into setupPressTimer() somehow!
-    CHECK(connect(this, &ScrollBar::sliderPositionChanged,
-                  &_sliderPressTimer, qOverload<>(&QTimer::start)));
-    CHECK(connect(&_sliderPressTimer, &QTimer::timeout,
-                  this, &ScrollBar::schedulePartialRedraw));
-    setupPressTimer(&_sliderPressTimer);
-
-    // TODO: move these connects into setupPressTimer() somehow!
-    CHECK(connect(this, &ScrollBar::backwardArrowClicked,
-                  &_backwardArrowPressTimer, qOverload<>(&QTimer::start)));
-    CHECK(connect(&_backwardArrowPressTimer, &QTimer::timeout,
-                  this, &ScrollBar::schedulePartialRedraw));
-    setupPressTimer(&_backwardArrowPressTimer);
-
-    // TODO: move these connects into setupPressTimer() somehow!
-    CHECK(connect(this, &ScrollBar::forwardArrowClicked,
-                  &_forwardArrowPressTimer, qOverload<>(&QTimer::start)));
-    CHECK(connect(&_forwardArrowPressTimer, &QTimer::timeout,
-                  this, &ScrollBar::schedulePartialRedraw));
-    setupPressTimer(&_forwardArrowPressTimer);
-
-    CHECK(connect(this, &ScrollBar::orientationChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::minimumChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::maximumChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::sliderPositionChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::sliderCharacterChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::sliderColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::sliderBackgroundColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::sliderActiveColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowUpCharacterChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowLeftCharacterChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowActiveColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowInactiveColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowActiveColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::backwardArrowInactiveColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowDownCharacterChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowRightCharacterChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowActiveColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowInactiveColorChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowActiveColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
-    CHECK(connect(this, &ScrollBar::forwardArrowInactiveColorBackgroundChanged,
-                  this, &ScrollBar::schedulePartialRedraw));
+    _sliderPressTimer = createPressTimer();
+    _backwardArrowPressTimer = createPressTimer();
+    _forwardArrowPressTimer = createPressTimer();
 
     //setBackgroundColor(Tg::Color::Predefined::Gray);
 }
 
-bool Tg::ScrollBar::consumeKeyboardBuffer(const QString &keyboardBuffer)
+bool Tg::ScrollBar::keyPressEvent(const KeyEvent &event)
 {
-     if (keyboardBuffer.contains(Tg::Key::up)
-             || keyboardBuffer.contains(Tg::Key::left)) {
+     if (event.key() == Key::Code::Up
+             || event.key() == Key::Code::Left) {
          const int position = sliderPosition();
-         if (position > 0) {
-             setSliderPosition(sliderPosition() - step());
+         int newPosition = position;
+         for (int i = 0; i < event.count() && newPosition > 0; ++i) {
+             newPosition -= step();
+         }
+
+         if (newPosition != position) {
+             setSliderPosition(newPosition);
          } else {
+             propertyChanged(PropertyId::SliderPosition);
              emit sliderPositionChanged(position);
          }
+         restartTimer(_backwardArrowPressTimer);
          emit backwardArrowClicked();
          return true;
      }
 
-     if (keyboardBuffer.contains(Tg::Key::down)
-             || keyboardBuffer.contains(Tg::Key::right)) {
+     if (event.key() == Key::Code::Down
+             || event.key() == Key::Code::Right) {
          const int position = sliderPosition();
+         int newPosition = position;
+         for (int i = 0; i < event.count() && newPosition < (length() - 3); ++i) {
+             newPosition += step();
+         }
 
-         if (position < (length() - 3)) {
-             setSliderPosition(sliderPosition() + step());
+         if (newPosition != position) {
+             setSliderPosition(newPosition);
          } else {
+             propertyChanged(PropertyId::SliderPosition);
              emit sliderPositionChanged(position);
          }
+         restartTimer(_forwardArrowPressTimer);
          emit forwardArrowClicked();
-         return true;;
+         return true;
      }
 
      return false;
@@ -646,7 +684,7 @@ QString Tg::ScrollBar::linearPixel(const int pixel, const int length) const
     if (pixel == 0) {
         // Draw first arrow
         // TODO: handle all the color madness ;-) Active, normal, inactive colors
-        if (_backwardArrowPressTimer.isActive()) {
+        if (isTimerActive(_backwardArrowPressTimer)) {
             result.append(Tg::Color::code(
                               backwardArrowActiveColor(),
                               backwardArrowActiveBackgroundColor()
@@ -668,7 +706,7 @@ QString Tg::ScrollBar::linearPixel(const int pixel, const int length) const
     } else if (pixel == length - 1) {
         // Draw second arrow
         // TODO: handle all the color madness ;-) Active, normal, inactive colors
-        if (_forwardArrowPressTimer.isActive()) {
+        if (isTimerActive(_forwardArrowPressTimer)) {
             result.append(Tg::Color::code(
                               forwardArrowActiveColor(),
                               forwardArrowActiveBackgroundColor()
@@ -705,7 +743,7 @@ QString Tg::ScrollBar::linearPixel(const int pixel, const int length) const
     const bool isSlider = ((pixel - 1) == position);
     if (isSlider) {
         // Draw slider
-        if (_sliderPressTimer.isActive()) {
+        if (isTimerActive(_sliderPressTimer)) {
             result.append(Tg::Color::code(
                               sliderActiveColor(), sliderActiveBackgroundColor()
                               ));
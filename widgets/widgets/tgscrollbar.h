@@ -3,7 +3,6 @@
 #include <widgets/tgwidget.h>
 
 #include <QString>
-#include <QTimer>
 
 namespace Tg {
 class ScrollBar : public Widget
@@ -160,8 +159,44 @@ protected slots:
     void enforceProperSize();
 
 protected:
+    /*!
+     * Properties of ScrollBar, see Widget::PropertyId.
+     */
+    struct PropertyId : Widget::PropertyId {
+        enum : int {
+            Orientation = Widget::PropertyId::Last,
+            Minimum,
+            Maximum,
+            SliderPosition,
+            SliderCharacter,
+            SliderColor,
+            SliderBackgroundColor,
+            SliderActiveColor,
+            BackwardArrowUpCharacter,
+            BackwardArrowLeftCharacter,
+            BackwardArrowColor,
+            BackwardArrowActiveColor,
+            BackwardArrowInactiveColor,
+            BackwardArrowColorBackground,
+            BackwardArrowActiveColorBackground,
+            BackwardArrowInactiveColorBackground,
+            ForwardArrowDownCharacter,
+            ForwardArrowRightCharacter,
+            ForwardArrowColor,
+            ForwardArrowActiveColor,
+            ForwardArrowInactiveColor,
+            ForwardArrowColorBackground,
+            ForwardArrowActiveColorBackground,
+            ForwardArrowInactiveColorBackground,
+            Last
+        };
+    };
+
     void init() override;
-    bool consumeKeyboardBuffer(const QString &keyboardBuffer) override;
+    void applyStyleOverrides(Style *resolved) const override;
+    bool hasStyleOverrides() const override;
+    void propertyChanged(const int property) override;
+    bool keyPressEvent(const KeyEvent &event) override;
     QString drawPixel(const QPoint &pixel) const override;
     QString linearPixel(const int pixel, const int length) const;
 
@@ -178,7 +213,7 @@ private:
     Tg::Color _sliderBackgroundColor;
     Tg::Color _sliderActiveBackgroundColor;
     Tg::Color _sliderInactiveBackgroundColor;
-    QTimer _sliderPressTimer;
+    TimerWheel::Handle _sliderPressTimer = TimerWheel::invalidHandle;
 
     QString _backwardArrowUpCharacter;
     QString _backwardArrowLeftCharacter;
@@ -188,7 +223,7 @@ private:
     Tg::Color _backwardArrowBackgroundColor;
     Tg::Color _backwardArrowActiveBackgroundColor;
     Tg::Color _backwardArrowInactiveBackgroundColor;
-    QTimer _backwardArrowPressTimer;
+    TimerWheel::Handle _backwardArrowPressTimer = TimerWheel::invalidHandle;
 
     QString _forwardArrowDownCharacter;
     QString _forwardArrowRightCharacter;
@@ -198,6 +233,6 @@ private:
     Tg::Color _forwardArrowBackgroundColor;
     Tg::Color _forwardArrowActiveBackgroundColor;
     Tg::Color _forwardArrowInactiveBackgroundColor;
-    QTimer _forwardArrowPressTimer;
+    TimerWheel::Handle _forwardArrowPressTimer = TimerWheel::invalidHandle;
 };
 }
@@ -0,0 +1,532 @@
+#include "tgtextedit.h"
+
+#include <tgkey.h>
+#include <tgunicode.h>
+
+#include <QRect>
+
+namespace {
+/*!
+ * Returns position right after \a text, if it was inserted at \a start.
+ */
+QPoint endPosition(const QPoint &start, const QString &text)
+{
+    const int lineBreaks = int(text.count(QLatin1Char('\n')));
+    if (lineBreaks == 0) {
+        return QPoint(start.x() + int(text.size()), start.y());
+    }
+
+    const int lastLineStart = int(text.lastIndexOf(QLatin1Char('\n'))) + 1;
+    return QPoint(int(text.size()) - lastLineStart, start.y() + lineBreaks);
+}
+}
+
+static_assert(sizeof(Tg::TextEdit) <= 416, "Tg::TextEdit has grown");
+
+Tg::TextEdit::TextEdit(Tg::Widget *parent) : Tg::ScrollArea(parent)
+{
+    TextEdit::init();
+}
+
+Tg::TextEdit::TextEdit(Tg::Screen *screen) : Tg::ScrollArea(screen)
+{
+    TextEdit::init();
+}
+
+QString Tg::TextEdit::text() const
+{
+    QString result;
+    const int count = lineCount();
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            result.append(QLatin1Char('\n'));
+        }
+        result.append(_lines.at(i));
+    }
+    return result;
+}
+
+QPoint Tg::TextEdit::cursorPosition() const
+{
+    return _cursorPosition;
+}
+
+int Tg::TextEdit::lineCount() const
+{
+    return _lines.size();
+}
+
+QString Tg::TextEdit::line(const int index) const
+{
+    if (index < 0 || index >= lineCount()) {
+        return {};
+    }
+
+    return _lines.at(index);
+}
+
+bool Tg::TextEdit::canUndo() const
+{
+    return _undoIndex > 0;
+}
+
+bool Tg::TextEdit::canRedo() const
+{
+    return _undoIndex < _undoStack.size();
+}
+
+void Tg::TextEdit::setText(const QString &text)
+{
+    _lines.clear();
+    const QStringList lines = text.split(QLatin1Char('\n'));
+    for (const QString &line : lines) {
+        _lines.insert(_lines.size(), line);
+    }
+
+    _undoStack.clear();
+    _undoIndex = 0;
+    _longestLine = 0;
+    updateLongestLine(0, lineCount() - 1);
+    _lineCells.clear();
+
+    updateChildrenDimensions();
+    setContentsPosition(QPoint(0, 0));
+    moveCursor(QPoint(0, 0));
+
+    propertyChanged(PropertyId::Text);
+    emit textChanged();
+}
+
+void Tg::TextEdit::setCursorPosition(const QPoint &cursorPosition)
+{
+    moveCursor(cursorPosition);
+}
+
+void Tg::TextEdit::insertText(const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+
+    const QPoint start = _cursorPosition;
+    const Edit edit = { Edit::Type::Insert, start, text };
+    const bool canMerge = _canMergeEdit && canRedo() == false && canUndo()
+            && _undoStack.last().type == Edit::Type::Insert
+            && endPosition(_undoStack.last().position,
+                           _undoStack.last().text) == start;
+
+    applyEdit(edit, false);
+
+    if (canMerge) {
+        _undoStack.last().text.append(text);
+    } else {
+        pushEdit(edit);
+    }
+
+    // Typing is undone in chunks, one line at a time
+    _canMergeEdit = text.contains(QLatin1Char('\n')) == false;
+}
+
+void Tg::TextEdit::undo()
+{
+    if (canUndo() == false) {
+        return;
+    }
+
+    --_undoIndex;
+    applyEdit(_undoStack.at(_undoIndex), true);
+}
+
+void Tg::TextEdit::redo()
+{
+    if (canRedo() == false) {
+        return;
+    }
+
+    applyEdit(_undoStack.at(_undoIndex), false);
+    ++_undoIndex;
+}
+
+void Tg::TextEdit::init()
+{
+    ScrollArea::init();
+
+    _lines.insert(0, QString());
+}
+
+bool Tg::TextEdit::keyPressEvent(const KeyEvent &event)
+{
+    const int count = event.count();
+    const int pageHeight = qMax(1, scrollableArea().height());
+
+    switch (event.key()) {
+    case Key::Code::Up:
+        moveCursor(verticalPosition(_cursorPosition.y() - count), true);
+        return true;
+    case Key::Code::Down:
+        moveCursor(verticalPosition(_cursorPosition.y() + count), true);
+        return true;
+    case Key::Code::PageUp:
+        moveCursor(verticalPosition(_cursorPosition.y() - (pageHeight * count)), true);
+        return true;
+    case Key::Code::PageDown:
+        moveCursor(verticalPosition(_cursorPosition.y() + (pageHeight * count)), true);
+        return true;
+    case Key::Code::Left: {
+        QPoint position = _cursorPosition;
+        for (int i = 0; i < count; ++i) {
+            position = previousPosition(position);
+        }
+        moveCursor(position);
+        return true;
+    }
+    case Key::Code::Right: {
+        QPoint position = _cursorPosition;
+        for (int i = 0; i < count; ++i) {
+            position = nextPosition(position);
+        }
+        moveCursor(position);
+        return true;
+    }
+    case Key::Code::Home:
+        moveCursor(QPoint(0, _cursorPosition.y()));
+        return true;
+    case Key::Code::End:
+        moveCursor(QPoint(int(_lines.at(_cursorPosition.y()).size()),
+                          _cursorPosition.y()));
+        return true;
+    case Key::Code::Backspace: {
+        QPoint from = _cursorPosition;
+        for (int i = 0; i < count; ++i) {
+            from = previousPosition(from);
+        }
+        removeText(from, _cursorPosition);
+        return true;
+    }
+    case Key::Code::Delete: {
+        QPoint to = _cursorPosition;
+        for (int i = 0; i < count; ++i) {
+            to = nextPosition(to);
+        }
+        removeText(_cursorPosition, to);
+        return true;
+    }
+    case Key::Code::Enter:
+        insertText(QString(count, QLatin1Char('\n')));
+        return true;
+    case Key::Code::Character:
+    case Key::Code::Space:
+        if (event.modifiers().testFlag(Key::Modifier::Ctrl)) {
+            if (event.text() == QStringLiteral("z")) {
+                undo();
+                return true;
+            }
+
+            if (event.text() == QStringLiteral("y")) {
+                redo();
+                return true;
+            }
+
+            return false;
+        }
+
+        if (event.modifiers().testFlag(Key::Modifier::Alt)) {
+            if (event.text() == QStringLiteral("u")) {
+                undo();
+                return true;
+            }
+
+            if (event.text() == QStringLiteral("e")) {
+                redo();
+                return true;
+            }
+
+            return false;
+        }
+
+        insertText(event.text());
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool Tg::TextEdit::pasteEvent(const PasteEvent &event)
+{
+    insertText(event.text());
+    return true;
+}
+
+QString Tg::TextEdit::drawAreaContents(const QPoint &pixel) const
+{
+    const QPoint childPx = childPixel(pixel);
+    if (childPx.y() < 0 || childPx.y() >= lineCount()) {
+        return {};
+    }
+
+    updateCachedLine(childPx.y());
+
+    const bool isCursor = hasFocus()
+            && childPx == QPoint(_cursorColumn, _cursorPosition.y());
+    QString result = isCursor? Tg::Color::code(backgroundColor(), textColor())
+                             : Tg::Color::code(textColor(), backgroundColor());
+
+    if (_lineCells.appendCell(childPx.x(), &result) == false) {
+        if (isCursor) {
+            result.append(Tg::Key::space);
+        } else {
+            result.append(backgroundCharacter());
+        }
+    }
+    return result;
+}
+
+void Tg::TextEdit::updateChildrenDimensions()
+{
+    // One more column, for the cursor at the end of the longest line
+    setChildrenDimensions(_longestLine + 1, lineCount());
+}
+
+void Tg::TextEdit::applyEdit(const Edit &edit, const bool isUndo)
+{
+    const bool isInsert = (edit.type == Edit::Type::Insert) != isUndo;
+    const QPoint start = edit.position;
+    const QPoint end = endPosition(start, edit.text);
+
+    if (isInsert) {
+        insertIntoDocument(start, edit.text);
+    } else {
+        removeFromDocument(start, end);
+    }
+
+    _lineCells.clear();
+    updateLongestLine(start.y(), isInsert? end.y() : start.y());
+    updateChildrenDimensions();
+
+    // When lines are added or removed, all rows below move
+    scheduleLinesRedraw(start.y(), (start.y() == end.y())? start.y() : -1);
+    moveCursor(isInsert? end : start);
+
+    emit textChanged();
+}
+
+void Tg::TextEdit::insertIntoDocument(const QPoint &position, const QString &text)
+{
+    const QStringList parts = text.split(QLatin1Char('\n'));
+    QString &line = _lines[position.y()];
+    if (parts.size() == 1) {
+        line.insert(position.x(), text);
+        return;
+    }
+
+    const QString tail = line.mid(position.x());
+    line.truncate(position.x());
+    line.append(parts.first());
+
+    const int lastPart = int(parts.size()) - 1;
+    for (int i = 1; i < lastPart; ++i) {
+        _lines.insert(position.y() + i, parts.at(i));
+    }
+    _lines.insert(position.y() + lastPart, parts.last() + tail);
+}
+
+void Tg::TextEdit::removeFromDocument(const QPoint &from, const QPoint &to)
+{
+    if (from.y() == to.y()) {
+        _lines[from.y()].remove(from.x(), to.x() - from.x());
+        return;
+    }
+
+    const QString tail = _lines.at(to.y()).mid(to.x());
+    QString &line = _lines[from.y()];
+    line.truncate(from.x());
+    line.append(tail);
+
+    _lines.remove(from.y() + 1, to.y() - from.y());
+}
+
+void Tg::TextEdit::removeText(const QPoint &from, const QPoint &to)
+{
+    if (from == to) {
+        return;
+    }
+
+    // Text between the positions is needed to undo the removal
+    QString removed;
+    if (from.y() == to.y()) {
+        removed = _lines.at(from.y()).mid(from.x(), to.x() - from.x());
+    } else {
+        removed = _lines.at(from.y()).mid(from.x());
+        for (int i = from.y() + 1; i < to.y(); ++i) {
+            removed.append(QLatin1Char('\n'));
+            removed.append(_lines.at(i));
+        }
+        removed.append(QLatin1Char('\n'));
+        removed.append(_lines.at(to.y()).left(to.x()));
+    }
+
+    const Edit edit = { Edit::Type::Remove, from, removed };
+    applyEdit(edit, false);
+    pushEdit(edit);
+}
+
+void Tg::TextEdit::pushEdit(const Edit &edit)
+{
+    // New edit makes undone edits impossible to redo
+    _undoStack.resize(_undoIndex);
+    _undoStack.append(edit);
+
+    if (_undoStack.size() > maximumUndoCount) {
+        _undoStack.removeFirst();
+    }
+
+    _undoIndex = int(_undoStack.size());
+}
+
+void Tg::TextEdit::updateLongestLine(const int firstLine, const int lastLine)
+{
+    // Longest line is not updated when lines get shorter, it only serves
+    // as horizontal scrolling range
+    for (int i = firstLine; i <= lastLine; ++i) {
+        _longestLine = qMax(_longestLine, Unicode::width(_lines.at(i)));
+    }
+}
+
+QPoint Tg::TextEdit::previousPosition(const QPoint &position) const
+{
+    if (position.x() > 0) {
+        const QString &text = _lines.at(position.y());
+        return QPoint(Unicode::previousGraphemeBoundary(text, position.x()),
+                      position.y());
+    }
+
+    if (position.y() > 0) {
+        const int line = position.y() - 1;
+        return QPoint(int(_lines.at(line).size()), line);
+    }
+
+    return position;
+}
+
+QPoint Tg::TextEdit::nextPosition(const QPoint &position) const
+{
+    const QString &text = _lines.at(position.y());
+    if (position.x() < text.size()) {
+        return QPoint(Unicode::nextGraphemeBoundary(text, position.x()),
+                      position.y());
+    }
+
+    if (position.y() < (lineCount() - 1)) {
+        return QPoint(0, position.y() + 1);
+    }
+
+    return position;
+}
+
+QPoint Tg::TextEdit::verticalPosition(const int line) const
+{
+    const int index = qBound(0, line, lineCount() - 1);
+    const QString &text = _lines.at(index);
+    const int size = int(text.size());
+
+    // Find the last cluster which starts before preferred column
+    int column = 0;
+    int position = 0;
+    while (position < size) {
+        const int width = Unicode::graphemeWidth(text, position);
+        if (column + width > _preferredColumn) {
+            break;
+        }
+
+        column += width;
+        position = Unicode::nextGraphemeBoundary(text, position);
+    }
+
+    return QPoint(position, index);
+}
+
+QPoint Tg::TextEdit::clampedPosition(const QPoint &position) const
+{
+    const int line = qBound(0, position.y(), lineCount() - 1);
+    const int x = qBound(0, position.x(), int(_lines.at(line).size()));
+    return QPoint(x, line);
+}
+
+int Tg::TextEdit::displayColumn(const QPoint &position) const
+{
+    return Unicode::width(_lines.at(position.y()).left(position.x()));
+}
+
+void Tg::TextEdit::moveCursor(const QPoint &position, const bool keepsColumn)
+{
+    const QPoint oldPosition = _cursorPosition;
+    const int oldColumn = _cursorColumn;
+
+    _canMergeEdit = false;
+    _cursorPosition = clampedPosition(position);
+    _cursorColumn = displayColumn(_cursorPosition);
+    if (keepsColumn == false) {
+        _preferredColumn = _cursorColumn;
+    }
+
+    ensureCursorVisible();
+
+    if (_cursorPosition == oldPosition && _cursorColumn == oldColumn) {
+        return;
+    }
+
+    // Setting cursor position does not go through propertyChanged(): only
+    // rows with old and new cursor are redrawn, not the whole editor
+    scheduleLinesRedraw(oldPosition.y(), oldPosition.y());
+    scheduleLinesRedraw(_cursorPosition.y(), _cursorPosition.y());
+
+    if (_cursorPosition != oldPosition) {
+        emit cursorPositionChanged(_cursorPosition);
+    }
+}
+
+void Tg::TextEdit::ensureCursorVisible()
+{
+    const QRect area = scrollableArea();
+    const int height = qMax(1, area.height());
+    const int width = qMax(1, area.width());
+
+    int top = firstVisibleRow();
+    int left = -contentsPosition().x();
+
+    if (_cursorPosition.y() < top) {
+        top = _cursorPosition.y();
+    } else if (_cursorPosition.y() >= (top + height)) {
+        top = _cursorPosition.y() - height + 1;
+    }
+
+    if (_cursorColumn < left) {
+        left = _cursorColumn;
+    } else if (_cursorColumn >= (left + width)) {
+        left = _cursorColumn - width + 1;
+    }
+
+    setContentsPosition(QPoint(-left, -top));
+}
+
+void Tg::TextEdit::scheduleLinesRedraw(const int firstLine, const int lastLine)
+{
+    const QRect area = scrollableArea();
+    const int top = firstVisibleRow();
+    const int firstRow = qMax(0, firstLine - top);
+    const int lastRow = (lastLine == -1)? area.height() - 1
+                                        : qMin(area.height() - 1, lastLine - top);
+    if (lastRow < firstRow) {
+        return;
+    }
+
+    scheduleRectangleRedraw(QRect(area.x(), area.y() + firstRow,
+                                  area.width(), lastRow - firstRow + 1));
+}
+
+void Tg::TextEdit::updateCachedLine(const int index) const
+{
+    if (_lineCells.contains(index) == false) {
+        _lineCells.setLine(index, _lines.at(index));
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <widgets/tgscrollarea.h>
+#include <utils/tggapbuffer.h>
+#include <utils/tglinecells.h>
+
+#include <QPoint>
+#include <QString>
+#include <QVector>
+
+namespace Tg {
+/*!
+ * \brief Multi-line text editor.
+ *
+ * TextEdit keeps its text as a list of lines in a GapBuffer, and every line
+ * is edited in place, so a keystroke costs as much as the edited line,
+ * regardless of how long the whole text is. Lines are laid out only when
+ * they are drawn, and after an edit only the rows which changed are redrawn.
+ *
+ * Edits are recorded on an undo stack: Alt+U undoes and Alt+E redoes them.
+ * Ctrl+Z and Ctrl+Y work too, if the terminal does not turn them into
+ * signals (see RawTerminalLocker). Consecutive typed characters are undone
+ * together.
+ *
+ * Lines are not wrapped, the view scrolls to keep the cursor visible.
+ */
+class TextEdit : public ScrollArea
+{
+    Q_OBJECT
+
+    /*!
+     * Whole text of the editor, lines are separated with `\n`.
+     *
+     * \note Building it takes time proportional to the size of the text:
+     * use line() and lineCount() to inspect large documents.
+     */
+    Q_PROPERTY(QString text READ text WRITE setText NOTIFY textChanged)
+
+    /*!
+     * Position of the cursor: x is the index of a character in its line,
+     * y is the line number. Both count from 0.
+     */
+    Q_PROPERTY(QPoint cursorPosition READ cursorPosition WRITE setCursorPosition NOTIFY cursorPositionChanged)
+
+public:
+    TextEdit(Widget *parent);
+    TextEdit(Screen *screen);
+
+    QString text() const;
+    QPoint cursorPosition() const;
+
+    int lineCount() const;
+    QString line(const int index) const;
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /*!
+     * Maximum number of edits which can be undone.
+     */
+    static const int maximumUndoCount = 1000;
+
+public slots:
+    /*!
+     * Replaces whole text with \a text. Clears the undo stack.
+     */
+    void setText(const QString &text);
+    void setCursorPosition(const QPoint &cursorPosition);
+
+    /*!
+     * Inserts \a text at cursor position, and moves the cursor after it.
+     * This can be undone.
+     */
+    void insertText(const QString &text);
+
+    void undo();
+    void redo();
+
+signals:
+    /*!
+     * Emitted after every change of the text. Text is not passed as an
+     * argument, as building it is expensive.
+     */
+    void textChanged() const;
+    void cursorPositionChanged(const QPoint &cursorPosition) const;
+
+protected:
+    /*!
+     * Properties of TextEdit, see Widget::PropertyId.
+     */
+    struct PropertyId : ScrollArea::PropertyId {
+        enum : int {
+            Text = ScrollArea::PropertyId::Last,
+            Last
+        };
+    };
+
+    void init() override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    bool pasteEvent(const PasteEvent &event) override;
+    QString drawAreaContents(const QPoint &pixel) const override;
+
+protected slots:
+    void updateChildrenDimensions() override;
+
+private:
+    struct Edit {
+        enum class Type {
+            Insert,
+            Remove
+        };
+
+        Type type = Type::Insert;
+        QPoint position;
+        QString text;
+    };
+
+    /*!
+     * Applies \a edit to the document (or reverts it, if \a isUndo is
+     * `true`), moves the cursor and schedules redraw of changed rows.
+     */
+    void applyEdit(const Edit &edit, const bool isUndo);
+    void insertIntoDocument(const QPoint &position, const QString &text);
+    void removeFromDocument(const QPoint &from, const QPoint &to);
+    void removeText(const QPoint &from, const QPoint &to);
+    void pushEdit(const Edit &edit);
+    void updateLongestLine(const int firstLine, const int lastLine);
+
+    QPoint previousPosition(const QPoint &position) const;
+    QPoint nextPosition(const QPoint &position) const;
+    QPoint verticalPosition(const int line) const;
+    QPoint clampedPosition(const QPoint &position) const;
+    int displayColumn(const QPoint &position) const;
+
+    void moveCursor(const QPoint &position, const bool keepsColumn = false);
+    void ensureCursorVisible();
+    void scheduleLinesRedraw(const int firstLine, const int lastLine);
+    void updateCachedLine(const int index) const;
+
+    GapBuffer<QString> _lines;
+    QPoint _cursorPosition;
+    // Display column of the cursor
+    int _cursorColumn = 0;
+    // Column kept when moving up and down through shorter lines
+    int _preferredColumn = 0;
+    int _longestLine = 0;
+
+    // Edits before _undoIndex are applied, the ones after it can be redone
+    QVector<Edit> _undoStack;
+    int _undoIndex = 0;
+    // Typing is merged into the last Insert edit until cursor is moved
+    bool _canMergeEdit = false;
+
+    // Last drawn line
+    mutable LineCells _lineCells;
+};
+}
@@ -0,0 +1,263 @@
+#include "tgtextview.h"
+#include "utils/tglineindexer.h"
+
+#include <tgkey.h>
+#include <tgunicode.h>
+
+#include <QRect>
+#include <QStringList>
+
+#include <algorithm>
+
+static_assert(sizeof(Tg::TextView) <= 416, "Tg::TextView has grown");
+
+Tg::TextView::TextView(Tg::Widget *parent) : Tg::ScrollArea(parent)
+{
+    TextView::init();
+}
+
+Tg::TextView::TextView(Tg::Screen *screen) : Tg::ScrollArea(screen)
+{
+    TextView::init();
+}
+
+Tg::TextView::~TextView()
+{
+    close();
+}
+
+QString Tg::TextView::fileName() const
+{
+    return _fileName;
+}
+
+int Tg::TextView::lineCount() const
+{
+    return qMax(0, int(_lineStarts.size()) - 1);
+}
+
+bool Tg::TextView::isIndexing() const
+{
+    return _indexer && _indexer->isFinished() == false;
+}
+
+QString Tg::TextView::line(const int index) const
+{
+    if (index < 0 || index >= lineCount()) {
+        return {};
+    }
+
+    const qint64 start = _lineStarts.at(index);
+    qint64 length = _lineStarts.at(index + 1) - 1 - start;
+    if (length > 0 && _data[start + length - 1] == '\r') {
+        --length;
+    }
+
+    const char *bytes = reinterpret_cast<const char *>(_data + start);
+    const QString text = QString::fromUtf8(bytes, int(qMin(length, qint64(maxLineLength))));
+    if (text.contains(QLatin1Char('\t')) == false) {
+        return text;
+    }
+
+    // Tab stops are counted in display columns, text between tabs may hold
+    // wide characters or several QChars per column
+    QString result;
+    int column = 0;
+    const QStringList segments = text.split(QLatin1Char('\t'));
+    for (int i = 0; i < segments.size(); ++i) {
+        if (i > 0) {
+            const int spaces = tabWidth - (column % tabWidth);
+            result.append(QString(spaces, QLatin1Char(' ')));
+            column += spaces;
+        }
+
+        result.append(segments.at(i));
+        column += Unicode::width(segments.at(i));
+    }
+    return result;
+}
+
+int Tg::TextView::lineAt(const qint64 offset) const
+{
+    if (offset < 0 || lineCount() == 0 || offset >= _lineStarts.last()) {
+        return -1;
+    }
+
+    const auto it = std::upper_bound(_lineStarts.constBegin(),
+                                     _lineStarts.constEnd(), offset);
+    return int(it - _lineStarts.constBegin()) - 1;
+}
+
+int Tg::TextView::firstVisibleLine() const
+{
+    return firstVisibleRow();
+}
+
+void Tg::TextView::setFileName(const QString &fileName)
+{
+    if (_fileName == fileName)
+        return;
+
+    close();
+
+    _lineStarts.clear();
+    _lineStarts.append(0);
+    _longestLine = 0;
+    _lineCells.clear();
+    setContentsPosition(QPoint(0, 0));
+    updateChildrenDimensions();
+
+    _fileName = fileName;
+    open();
+
+    propertyChanged(PropertyId::FileName);
+    emit fileNameChanged(_fileName);
+}
+
+void Tg::TextView::scrollToLine(const int line)
+{
+    const int lastTopLine = qMax(0, lineCount() - scrollableArea().height());
+    const int top = qBound(0, line, lastTopLine);
+    setContentsPosition(QPoint(contentsPosition().x(), -top));
+}
+
+void Tg::TextView::init()
+{
+    ScrollArea::init();
+
+    _lineStarts.append(0);
+}
+
+bool Tg::TextView::keyPressEvent(const KeyEvent &event)
+{
+    const int pageHeight = qMax(1, scrollableArea().height());
+
+    switch (event.key()) {
+    case Key::Code::PageDown:
+        scrollToLine(firstVisibleLine() + (pageHeight * event.count()));
+        return true;
+    case Key::Code::PageUp:
+        scrollToLine(firstVisibleLine() - (pageHeight * event.count()));
+        return true;
+    case Key::Code::Home:
+        scrollToLine(0);
+        return true;
+    case Key::Code::End:
+        scrollToLine(lineCount());
+        return true;
+    default:
+        return ScrollArea::keyPressEvent(event);
+    }
+}
+
+QString Tg::TextView::drawAreaContents(const QPoint &pixel) const
+{
+    const QPoint childPx = childPixel(pixel);
+    if (childPx.y() < 0 || childPx.y() >= lineCount()) {
+        return {};
+    }
+
+    updateCachedLine(childPx.y());
+
+    QString result = Tg::Color::code(textColor(), backgroundColor());
+    if (_lineCells.appendCell(childPx.x(), &result) == false) {
+        result.append(backgroundCharacter());
+    }
+    return result;
+}
+
+void Tg::TextView::updateChildrenDimensions()
+{
+    // LineIndexer reports an upper bound of line width: no UTF-8 character
+    // is wider than its byte count, and a tab takes at most tabWidth columns
+    setChildrenDimensions(_longestLine, lineCount());
+}
+
+void Tg::TextView::takeIndexedLines()
+{
+    if (_indexer.isNull()) {
+        return;
+    }
+
+    const QVector<qint64> lineStarts = _indexer->takeLineStarts();
+    if (lineStarts.isEmpty()) {
+        return;
+    }
+
+    const int oldLineCount = lineCount();
+    _lineStarts.append(lineStarts);
+    _longestLine = _indexer->longestLine();
+    updateChildrenDimensions();
+
+    // Only redraw if new lines are visible
+    if (oldLineCount < firstVisibleLine() + scrollableArea().height()) {
+        schedulePartialRedraw();
+    }
+
+    emit lineCountChanged(lineCount());
+}
+
+void Tg::TextView::onIndexerFinished()
+{
+    // Indexer of a previous file could finish after it has been replaced
+    if (sender() != _indexer) {
+        return;
+    }
+
+    takeIndexedLines();
+    emit indexingFinished();
+}
+
+void Tg::TextView::open()
+{
+    if (_fileName.isEmpty()) {
+        return;
+    }
+
+    _file.setFileName(_fileName);
+    if (_file.open(QFile::ReadOnly) == false) {
+        return;
+    }
+
+    _dataSize = _file.size();
+    if (_dataSize > 0) {
+        _data = _file.map(0, _dataSize);
+    }
+
+    if (_data == nullptr) {
+        _dataSize = 0;
+        _file.close();
+        return;
+    }
+
+    _indexer = new LineIndexer(_data, _dataSize, tabWidth, this);
+    CHECK(connect(_indexer, &LineIndexer::linesIndexed,
+                  this, &TextView::takeIndexedLines));
+    CHECK(connect(_indexer, &LineIndexer::finished,
+                  this, &TextView::onIndexerFinished));
+    _indexer->start(QThread::LowPriority);
+}
+
+void Tg::TextView::close()
+{
+    // Indexer reads mapped memory, it has to be stopped before unmapping
+    if (_indexer) {
+        _indexer->stop();
+        delete _indexer;
+    }
+
+    if (_data) {
+        _file.unmap(_data);
+        _data = nullptr;
+    }
+
+    _dataSize = 0;
+    _file.close();
+}
+
+void Tg::TextView::updateCachedLine(const int index) const
+{
+    if (_lineCells.contains(index) == false) {
+        _lineCells.setLine(index, line(index));
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <widgets/tgscrollarea.h>
+#include <utils/tglinecells.h>
+
+#include <QFile>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+namespace Tg {
+class LineIndexer;
+
+/*!
+ * \brief Read-only viewer of (possibly very large) text files.
+ *
+ * TextView memory-maps the file instead of reading it, and indexes where its
+ * lines start in a background thread (see LineIndexer). Lines are shown as
+ * soon as they are indexed: the first screen of even a multi-gigabyte file
+ * is ready in milliseconds, and lineCount() keeps growing until
+ * indexingFinished() is emitted.
+ *
+ * Only visible lines are ever decoded, one at a time, when they are drawn.
+ * Text is not wrapped, scroll horizontally to see the rest of long lines.
+ *
+ * \code
+ * auto view = new Tg::TextView(parent);
+ * view->setFileName("/var/log/syslog");
+ * view->scrollToLine(1000);
+ * \endcode
+ *
+ * File is expected to be UTF-8 encoded. Tabs are expanded to the next
+ * multiple of 8 characters.
+ */
+class TextView : public ScrollArea
+{
+    Q_OBJECT
+
+    /*!
+     * Path to the file which is shown. Setting it to an empty string, or to
+     * a file which cannot be opened, clears the view.
+     */
+    Q_PROPERTY(QString fileName READ fileName WRITE setFileName NOTIFY fileNameChanged)
+
+public:
+    TextView(Widget *parent);
+    TextView(Screen *screen);
+    ~TextView();
+
+    QString fileName() const;
+
+    /*!
+     * Returns number of lines indexed so far.
+     */
+    int lineCount() const;
+
+    /*!
+     * Returns `true` while lines of the file are still being indexed.
+     */
+    bool isIndexing() const;
+
+    /*!
+     * Returns text of line number \a index (counting from 0), without the
+     * line break. Lines longer than maxLineLength bytes are cut.
+     */
+    QString line(const int index) const;
+
+    /*!
+     * Returns number of the line which contains byte at \a offset of the
+     * file, or `-1` if that part of the file has not been indexed yet.
+     * Runs in O(log n).
+     */
+    int lineAt(const qint64 offset) const;
+
+    /*!
+     * Returns number of the first visible line.
+     */
+    int firstVisibleLine() const;
+
+    /*!
+     * Only this many bytes of every line are decoded and shown.
+     */
+    static const int maxLineLength = 64 * 1024;
+
+public slots:
+    void setFileName(const QString &fileName);
+
+    /*!
+     * Scrolls the view so that \a line is the first visible line (or as
+     * close to the top as possible, near the end of the file).
+     */
+    void scrollToLine(const int line);
+
+signals:
+    void fileNameChanged(const QString &fileName) const;
+    void lineCountChanged(const int lineCount) const;
+    void indexingFinished() const;
+
+protected:
+    /*!
+     * Properties of TextView, see Widget::PropertyId.
+     */
+    struct PropertyId : ScrollArea::PropertyId {
+        enum : int {
+            FileName = ScrollArea::PropertyId::Last,
+            Last
+        };
+    };
+
+    void init() override;
+    bool keyPressEvent(const KeyEvent &event) override;
+    QString drawAreaContents(const QPoint &pixel) const override;
+
+protected slots:
+    void updateChildrenDimensions() override;
+
+private slots:
+    void takeIndexedLines();
+    void onIndexerFinished();
+
+private:
+    void open();
+    void close();
+    void updateCachedLine(const int index) const;
+
+    static const int tabWidth = 8;
+
+    QString _fileName;
+    QFile _file;
+    uchar *_data = nullptr;
+    qint64 _dataSize = 0;
+
+    QPointer<LineIndexer> _indexer;
+    // Line N occupies bytes from _lineStarts[N] up to _lineStarts[N + 1] - 1
+    QVector<qint64> _lineStarts;
+    int _longestLine = 0;
+
+    // Last drawn line. Screen draws row by row, so a line is decoded once
+    // per redraw
+    mutable LineCells _lineCells;
+};
+}
@@ -9,12 +9,26 @@
 #include <QRect>
 #include <QDebug>
 
+#include <algorithm>
+
+// Every Widget pays for these bytes, keep rarely set properties in
+// ExtraProperties. Bounds in this module are sizes on Qt 6, 64 bit
+static_assert(sizeof(Tg::Widget) <= 208, "Tg::Widget has grown");
+
 Tg::Widget::Widget(Widget *parent)
     : QObject(parent),
       _screen(parent->screen()),
       _parentWidget(parent)
 {
     Widget::init();
+
+    // Done here and not in init(), which runs once for every class in the
+    // hierarchy of this Widget: the child must be added exactly once
+    _parentWidget->addChildWidget(this);
+    emit _parentWidget->childAdded(this);
+
+    CHECK(connect(this, &Widget::destroyed,
+                  _parentWidget, &Widget::childRemoved));
 }
 
 Tg::Widget::Widget(Tg::Screen *screen)
@@ -35,7 +49,22 @@ Tg::Widget::~Widget()
         }
         _screen->deregisterWidget(this);
         _screen->deregisterCurrentModalWidget(this);
+
+        for (const TimerWheel::Handle handle : extraProperties().timers) {
+            _screen->destroyWidgetTimer(handle);
+        }
+    }
+
+    if (_parentWidget) {
+        _parentWidget->removeChildWidget(this);
+    }
+
+    // Style does not own its BorderStyle, see updateResolvedStyle()
+    if (extraProperties().resolvedStyle) {
+        delete extraProperties().resolvedStyle->border;
     }
+
+    delete _layout;
 }
 
 QPoint Tg::Widget::position() const
@@ -65,12 +94,14 @@ QRect Tg::Widget::boundingRectangle() const
 
 QRect Tg::Widget::globalBoundingRectangle() const
 {
-    if (parentWidget()) {
-        const int border = parentWidget()->effectiveBorderWidth();
-        return QRect(mapToGlobal(QPoint(border, border)), size());
-    } else {
-        return QRect(mapToGlobal(QPoint(0, 0)), size());
-    }
+    updateGlobalGeometry();
+    return _geometryCache->globalBoundingRectangle;
+}
+
+QRect Tg::Widget::globalClipRectangle() const
+{
+    updateGlobalGeometry();
+    return _geometryCache->globalClipRectangle;
 }
 
 QRect Tg::Widget::globalPreviousBoundingRectangle() const
@@ -98,52 +129,32 @@ QRect Tg::Widget::contentsRectangle() const
 
 Tg::Color Tg::Widget::backgroundColor() const
 {
-    if (_backgroundColor.isEmpty()) {
-        return style()->backgroundColor;
-    } else {
-        return _backgroundColor;
-    }
+    return resolvedStyle().backgroundColor;
 }
 
 QByteArray Tg::Widget::backgroundCharacter() const
 {
-    if (_backgroundCharacter.isNull()) {
-        return style()->backgroundCharacter;
-    } else {
-        return _backgroundCharacter;
-    }
+    return resolvedStyle().backgroundCharacter;
 }
 
 Tg::Color Tg::Widget::textColor() const
 {
-    if (_textColor.isEmpty()) {
-        return style()->textColor;
-    } else {
-        return _textColor;
-    }
+    return resolvedStyle().textColor;
 }
 
 QString Tg::Widget::title() const
 {
-    return _title;
+    return extraProperties().title;
 }
 
 Tg::Color Tg::Widget::borderTextColor() const
 {
-    if (_borderTextColor.isEmpty()) {
-        return style()->border->textColor;
-    } else {
-        return _borderTextColor;
-    }
+    return resolvedStyle().border->textColor;
 }
 
 Tg::Color Tg::Widget::borderBackgroundColor() const
 {
-    if (_borderBackgroundColor.isEmpty()) {
-        return style()->border->backgroundColor;
-    } else {
-        return _borderBackgroundColor;
-    }
+    return resolvedStyle().border->backgroundColor;
 }
 
 bool Tg::Widget::visible() const
@@ -177,6 +188,11 @@ void Tg::Widget::setAcceptsFocus(const bool accept)
 {
     if (_acceptsFocus != accept) {
         _acceptsFocus = accept;
+
+        if (_screen && _screenIndex != -1) {
+            _screen->updateFocusChain(this);
+        }
+
         emit acceptsFocusChanged(accept);
     }
 }
@@ -185,6 +201,7 @@ void Tg::Widget::setHasFocus(const bool active)
 {
     if (_hasFocus != active) {
         _hasFocus = active;
+        propertyChanged(PropertyId::HasFocus);
         emit hasFocusChanged(active);
     }
 }
@@ -220,36 +237,37 @@ QString Tg::Widget::drawBorderPixel(const QPoint &pixel) const
 
     const auto color = Tg::Color::code(borderTextColor(), borderBackgroundColor());
     // TODO: add property to make overshoot color customizable
-    const auto overshootColor = Tg::Color::code(style()->border->overshootTextColor,
-                                                      style()->border->overshootBackgroundColor);
+    const auto overshootColor = Tg::Color::code(resolvedStyle().border->overshootTextColor,
+                                                      resolvedStyle().border->overshootBackgroundColor);
 
     const QRect rect(QPoint(0, 0), size());
     if (pixel == rect.topLeft()) {
         result.append(color);
-        result.append(style()->border->topLeft);
+        result.append(resolvedStyle().border->topLeft);
     } else if (pixel == rect.topRight()) {
         result.append(color);
-        result.append(style()->border->topRight);
+        result.append(resolvedStyle().border->topRight);
     } else if (pixel == rect.bottomLeft()) {
         result.append(color);
-        result.append(style()->border->bottomLeft);
+        result.append(resolvedStyle().border->bottomLeft);
     } else if (pixel == rect.bottomRight()) {
         if (_resizableByMouse) {
             result.append(color);
-            result.append(style()->border->resizableCorner);
+            result.append(resolvedStyle().border->resizableCorner);
         } else {
             result.append(color);
-            result.append(style()->border->bottomRight);
+            result.append(resolvedStyle().border->bottomRight);
         }
     } else if (pixel.y() == rect.top()) {
         result.append(color);
 
-        const auto border = style()->border->horizontal;
+        const auto border = resolvedStyle().border->horizontal;
         if (title().isEmpty()) {
             result.append(border);
         } else {
+            const LineCells &cells = extraProperties().titleCells;
             const int width = rect.width() - (2 * _borderWidth);
-            const int textWidth = title().size();
+            const int textWidth = cells.width();
             const int margin = (width - textWidth) / 2;
             // TODO: handle case where margin < 0
             const int x = pixel.x() - _borderWidth;
@@ -257,29 +275,29 @@ QString Tg::Widget::drawBorderPixel(const QPoint &pixel) const
             if (x < margin || x >= (margin + textWidth)) {
                 result.append(border);
             } else {
-                result.append(title().at(x - margin));
+                cells.appendCell(x - margin, &result);
             }
         }
     } else if (pixel.y() == rect.bottom()) {
         if (widgetOvershoot().testFlag(Overshoot::Vertical)
                 || layoutOvershoot().testFlag(Overshoot::Vertical)) {
             result.append(overshootColor);
-            result.append(style()->border->horizontalOvershoot);
+            result.append(resolvedStyle().border->horizontalOvershoot);
         } else {
             result.append(color);
-            result.append(style()->border->horizontal);
+            result.append(resolvedStyle().border->horizontal);
         }
     } else if (pixel.x() == rect.left()) {
         result.append(color);
-        result.append(style()->border->vertical);
+        result.append(resolvedStyle().border->vertical);
     } else if (pixel.x() == rect.right()) {
         if (widgetOvershoot().testFlag(Overshoot::Horizontal)
                 || layoutOvershoot().testFlag(Overshoot::Horizontal)) {
             result.append(overshootColor);
-            result.append(style()->border->verticalOvershoot);
+            result.append(resolvedStyle().border->verticalOvershoot);
         } else {
             result.append(color);
-            result.append(style()->border->vertical);
+            result.append(resolvedStyle().border->vertical);
         }
     } else {
         result.append(Tg::Key::space);
@@ -295,7 +313,7 @@ QString Tg::Widget::drawPixel(const QPoint &pixel) const
     if (isBorder(pixel)) {
         return drawBorderPixel(pixel);
     } else {
-        const auto children = childrenWidgets();
+        const auto &children = childrenWidgets();
         if (children.isEmpty() == false) {
             const QPoint contentsPixel(pixel - contentsRectangle().topLeft());
             const WidgetPointer widget = Helpers::topWidget(children, contentsPixel, WidgetType::All);
@@ -339,26 +357,14 @@ bool Tg::Widget::verticalArrowsMoveFocus() const
 
 QPoint Tg::Widget::mapFromGlobal(const QPoint &position) const
 {
-    const QPoint result(position - this->position());
-
-    if (parentWidget()) {
-        const int border = parentWidget()->effectiveBorderWidth();
-        return parentWidget()->mapFromGlobal(result) -
-            QPoint(border, border);
-    }
-
-    return result;
+    updateGlobalGeometry();
+    return position - _geometryCache->globalMappingOffset;
 }
 
 QPoint Tg::Widget::mapToGlobal(const QPoint &position) const
 {
-    const QPoint result(position + this->position());
-
-    if (parentWidget()) {
-        return parentWidget()->mapToGlobal(result);
-    }
-
-    return result;
+    updateGlobalGeometry();
+    return position + _geometryCache->globalPosition;
 }
 
 QPoint Tg::Widget::mapToChild(const Tg::WidgetPointer &child,
@@ -383,6 +389,7 @@ void Tg::Widget::setStyle(const Tg::StylePointer &style, const bool propagate)
 
     _style = style;
     setPropagatesStyle(propagate);
+    updateResolvedStyle();
 
     if (propagate) {
         for (auto child : children()) {
@@ -393,28 +400,33 @@ void Tg::Widget::setStyle(const Tg::StylePointer &style, const bool propagate)
         }
     }
 
+    propertyChanged(PropertyId::Style);
     emit styleChanged();
 }
 
 Tg::Layout::Type Tg::Widget::layoutType() const
 {
-    return _layout->type();
+    if (_layout) {
+        return _layout->type();
+    }
+
+    return Layout::Type::None;
 }
 
 void Tg::Widget::setLayoutType(const Tg::Layout::Type type)
 {
-    if (_layout) {
-        if (_layout->type() == type) {
-            return;
-        } else {
-            delete _layout;
-        }
+    if (layoutType() == type) {
+        return;
     }
 
+    delete _layout;
+    _layout = nullptr;
+
     switch (type) {
     case Layout::Type::None:
-        _layout = new Layout;
-        break;
+        // Widgets without a layout share one Layout object, see doLayout()
+        scheduleLayout();
+        return;
     case Layout::Type::ChildFillsParent:
         _layout = new ChildFillsParentLayout;
         break;
@@ -430,48 +442,69 @@ void Tg::Widget::setLayoutType(const Tg::Layout::Type type)
     }
 
     _layout->setParent(this);
-    doLayout();
+    scheduleLayout();
 }
 
 void Tg::Widget::doLayout()
 {
-    if (_layout) {
-        _layout->doLayout();
-
-        const auto overshoot = _layout->overshoot();
-        if (overshoot != _layoutOvershoot) {
-            _layoutOvershoot = overshoot;
-            _widgetOvershoot = overshoot;
-            emit layoutOvershootChanged(_layoutOvershoot);
-            emit widgetOvershootChanged(_widgetOvershoot);
-        }
+    _isLayoutDirty = false;
+
+    // Layout::Type::None only computes the overshoot, so instead of
+    // allocating a Layout for every Widget, a single one is borrowed
+    static Layout noneLayout;
+
+    Layout *layout = _layout? _layout : &noneLayout;
+    layout->setParent(this);
+    layout->doLayout();
+    const auto overshoot = layout->overshoot();
+
+    if (layout == &noneLayout) {
+        noneLayout.setParent(nullptr);
+    }
+
+    if (overshoot != _layoutOvershoot) {
+        _layoutOvershoot = overshoot;
+        _widgetOvershoot = overshoot;
+        propertyChanged(PropertyId::LayoutOvershoot);
+        emit layoutOvershootChanged(_layoutOvershoot);
+        propertyChanged(PropertyId::WidgetOvershoot);
+        emit widgetOvershootChanged(_widgetOvershoot);
     }
 }
 
-Tg::WidgetList Tg::Widget::childrenWidgets() const
+void Tg::Widget::scheduleLayout()
 {
-    WidgetList result;
-    for (QObject *child : qAsConst(children())) {
-        Widget *childWidget = qobject_cast<Widget *>(child);
-        if (childWidget) {
-            result.append(WidgetPointer(childWidget));
-        }
+    if (_isLayoutDirty) {
+        return;
     }
-    return result;
+
+    if (_screen.isNull()) {
+        doLayout();
+        return;
+    }
+
+    _isLayoutDirty = true;
+    _screen->scheduleWidgetLayout(this);
+}
+
+const Tg::WidgetList &Tg::Widget::childrenWidgets() const
+{
+    return _childrenWidgets;
 }
 
 Tg::WidgetList Tg::Widget::allFocusableChildrenWidgets() const
 {
     WidgetList result;
-    for (QObject *child : qAsConst(children())) {
-        Widget *childWidget = qobject_cast<Widget *>(child);
-        if (childWidget) {
-            if (childWidget->acceptsFocus()) {
-                result.append(WidgetPointer(childWidget));
-            }
+    for (const WidgetPointer &child : _childrenWidgets) {
+        if (child.isNull()) {
+            continue;
+        }
 
-            result.append(childWidget->allFocusableChildrenWidgets());
+        if (child->acceptsFocus()) {
+            result.append(child);
         }
+
+        result.append(child->allFocusableChildrenWidgets());
     }
     return result;
 }
@@ -508,6 +541,8 @@ void Tg::Widget::setPosition(const QPoint &position)
 
     updatePreviousBoundingRect();
     _position = position;
+    invalidateGlobalGeometry();
+    propertyChanged(PropertyId::Position);
     emit positionChanged(_position);
 }
 
@@ -518,9 +553,11 @@ void Tg::Widget::setSize(const QSize &size)
 
     updatePreviousBoundingRect();
     _size = size;
+    invalidateGlobalGeometry();
+    propertyChanged(PropertyId::Size);
     emit sizeChanged(_size);
 
-    doLayout();
+    scheduleLayout();
 }
 
 void Tg::Widget::setBackgroundColor(const Tg::Color &color)
@@ -529,52 +566,63 @@ void Tg::Widget::setBackgroundColor(const Tg::Color &color)
         return;
 
     _backgroundColor = color;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackgroundColor);
     emit backgroundColorChanged(_backgroundColor);
 }
 
 void Tg::Widget::setBackgroundCharacter(const QByteArray &character)
 {
-    if (_backgroundCharacter == character)
+    if (extraProperties().backgroundCharacter == character)
         return;
 
-    _backgroundCharacter = character;
-    emit backgroundCharacterChanged(_backgroundCharacter);
+    ensureExtraProperties().backgroundCharacter = character;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BackgroundCharacter);
+    emit backgroundCharacterChanged(character);
 }
 
 void Tg::Widget::setTextColor(const Tg::Color &color)
 {
-    if (_textColor == color)
+    if (extraProperties().textColor == color)
         return;
 
-    _textColor = color;
-    emit textColorChanged(_textColor);
+    ensureExtraProperties().textColor = color;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::TextColor);
+    emit textColorChanged(color);
 }
 
 void Tg::Widget::setTitle(const QString &title)
 {
-    if (_title == title)
+    if (extraProperties().title == title)
         return;
 
-    _title = title;
-    emit titleChanged(_title);
+    ExtraProperties &properties = ensureExtraProperties();
+    properties.title = title;
+    properties.titleCells.setLine(0, title);
+    emit titleChanged(title);
 }
 
 void Tg::Widget::setBorderTextColor(const Tg::Color &color)
 {
-    if (_borderTextColor == color)
+    if (extraProperties().borderTextColor == color)
         return;
 
-    _borderTextColor = color;
-    emit borderTextColorChanged(_borderTextColor);
+    ensureExtraProperties().borderTextColor = color;
+    updateResolvedStyle();
+    propertyChanged(PropertyId::BorderTextColor);
+    emit borderTextColorChanged(color);
 }
 
 void Tg::Widget::setBorderBackgroundColor(const Tg::Color &color)
 {
-    if (_borderBackgroundColor == color)
+    if (extraProperties().borderBackgroundColor == color)
         return;
 
-    _borderBackgroundColor = color;
-    emit borderBackgroundColorChanged(_borderBackgroundColor);
+    ensureExtraProperties().borderBackgroundColor = color;
+    updateResolvedStyle();
+    emit borderBackgroundColorChanged(color);
 }
 
 void Tg::Widget::setVisible(const bool visible)
@@ -584,10 +632,16 @@ void Tg::Widget::setVisible(const bool visible)
 
     _visible = visible;
 
+    // Hidden widgets are skipped by Tab navigation
+    if (_screen && _screenIndex != -1) {
+        _screen->updateFocusChain(this);
+    }
+
+    propertyChanged(PropertyId::Visible);
     emit visibleChanged(_visible);
 
     if (visible && parentWidget()) {
-        parentWidget()->doLayout();
+        parentWidget()->scheduleLayout();
 
         if (parentWidget()->propagatesStyle()) {
             parentWidget()->propagateStyleToChild(this);
@@ -615,6 +669,8 @@ void Tg::Widget::setBorderVisible(const bool visible)
         return;
 
     _borderVisible = visible;
+    invalidateGlobalGeometry();
+    propertyChanged(PropertyId::BorderVisible);
     emit borderVisibleChanged(_borderVisible);
 }
 
@@ -624,6 +680,11 @@ void Tg::Widget::setZ(const int z)
         return;
 
     _z = z;
+
+    if (_parentWidget) {
+        _parentWidget->sortChildrenWidgets();
+    }
+
     emit zChanged(_z);
 }
 
@@ -636,37 +697,62 @@ int Tg::Widget::effectiveBorderWidth() const
     return 0;
 }
 
-void Tg::Widget::init()
+bool Tg::Widget::hasStyleOverrides() const
+{
+    if (_backgroundColor.isEmpty() == false) {
+        return true;
+    }
+
+    if (_extraProperties.isNull()) {
+        return false;
+    }
+
+    return _extraProperties->backgroundCharacter.isNull() == false
+            || _extraProperties->textColor.isEmpty() == false
+            || _extraProperties->borderTextColor.isEmpty() == false
+            || _extraProperties->borderBackgroundColor.isEmpty() == false;
+}
+
+void Tg::Widget::applyStyleOverrides(Style *resolved) const
+{
+    if (_backgroundColor.isEmpty() == false) {
+        resolved->backgroundColor = _backgroundColor;
+    }
+
+    const ExtraProperties &extra = extraProperties();
+    if (extra.backgroundCharacter.isNull() == false) {
+        resolved->backgroundCharacter = extra.backgroundCharacter;
+    }
+
+    if (extra.textColor.isEmpty() == false) {
+        resolved->textColor = extra.textColor;
+    }
+
+    if (extra.borderTextColor.isEmpty() == false) {
+        resolved->border->textColor = extra.borderTextColor;
+    }
+
+    if (extra.borderBackgroundColor.isEmpty() == false) {
+        resolved->border->backgroundColor = extra.borderBackgroundColor;
+    }
+}
+
+void Tg::Widget::propertyChanged(const int property)
 {
-    CHECK(connect(this, &Widget::positionChanged,
-                  this, &Widget::schedulePreviousPositionRedraw));
-    CHECK(connect(this, &Widget::sizeChanged,
-                  this, &Widget::schedulePreviousPositionRedraw));
-
-    CHECK(connect(this, &Widget::backgroundColorChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::backgroundCharacterChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::textColorChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::borderTextColorChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::visibleChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::borderVisibleChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::hasFocusChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::styleChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::layoutOvershootChanged,
-                  this, &Widget::schedulePartialRedraw));
-    CHECK(connect(this, &Widget::widgetOvershootChanged,
-                  this, &Widget::schedulePartialRedraw));
+    switch (property) {
+    case PropertyId::Position:
+    case PropertyId::Size:
+        schedulePreviousPositionRedraw();
+        break;
+    default:
+        schedulePartialRedraw();
+        break;
+    }
+}
 
+void Tg::Widget::init()
+{
     if (_screen) {
-        CHECK(connect(this, &Widget::needsRedraw,
-                      _screen, &Screen::scheduleRedraw));
         _screen->registerWidget(this);
     } else {
         qCritical() << "Screen is missing, can't draw the widget!" << this;
@@ -675,22 +761,40 @@ void Tg::Widget::init()
     if (_parentWidget) {
         setBorderVisible(false);
 
-        _parentWidget->doLayout();
+        _parentWidget->scheduleLayout();
         if (_parentWidget->propagatesStyle()) {
             _parentWidget->propagateStyleToChild(this);
         }
 
-        emit _parentWidget->childAdded(this);
-
-        CHECK(connect(this, &Widget::destroyed,
-                      _parentWidget, &Widget::childRemoved));
-
         setVisible(_parentWidget->visible());
     }
 
     setLayoutType(Layout::Type::None);
 }
 
+bool Tg::Widget::keyPressEvent(const KeyEvent &event)
+{
+    return consumeKeyboardBuffer(QString::fromUtf8(event.sequence()));
+}
+
+bool Tg::Widget::mousePressEvent(const MouseEvent &event)
+{
+    Q_UNUSED(event)
+    return false;
+}
+
+bool Tg::Widget::wheelEvent(const WheelEvent &event)
+{
+    Q_UNUSED(event)
+    return false;
+}
+
+bool Tg::Widget::pasteEvent(const PasteEvent &event)
+{
+    Q_UNUSED(event)
+    return false;
+}
+
 bool Tg::Widget::consumeKeyboardBuffer(const QString &keyboardBuffer)
 {
     Q_UNUSED(keyboardBuffer)
@@ -722,33 +826,151 @@ Tg::StylePointer Tg::Widget::style() const
     return _style;
 }
 
+const Tg::Style &Tg::Widget::resolvedStyle() const
+{
+    if (extraProperties().resolvedStyle) {
+        return *extraProperties().resolvedStyle;
+    }
+
+    if (_style) {
+        return *_style;
+    }
+
+    static const Style defaultStyle;
+    return defaultStyle;
+}
+
+void Tg::Widget::updateResolvedStyle()
+{
+    if (_style.isNull()) {
+        return;
+    }
+
+    // Most widgets do not override anything, they read style() directly
+    if (hasStyleOverrides() == false) {
+        if (extraProperties().resolvedStyle) {
+            QScopedPointer<Style> &resolved = ensureExtraProperties().resolvedStyle;
+            delete resolved->border;
+            resolved.reset();
+        }
+        return;
+    }
+
+    QScopedPointer<Style> &resolved = ensureExtraProperties().resolvedStyle;
+    if (resolved.isNull()) {
+        resolved.reset(new Style);
+    }
+
+    // Keep the BorderStyle owned by the resolved Style, only copy the values
+    BorderStyle *border = resolved->border;
+    *resolved = *_style;
+    *border = *_style->border;
+    resolved->border = border;
+
+    applyStyleOverrides(resolved.data());
+}
+
+const Tg::Widget::ExtraProperties &Tg::Widget::extraProperties() const
+{
+    if (_extraProperties) {
+        return *_extraProperties;
+    }
+
+    static const ExtraProperties defaultProperties;
+    return defaultProperties;
+}
+
+Tg::Widget::ExtraProperties &Tg::Widget::ensureExtraProperties()
+{
+    if (_extraProperties.isNull()) {
+        _extraProperties.reset(new ExtraProperties);
+    }
+
+    return *_extraProperties;
+}
+
+Tg::Widget::GeometryCache &Tg::Widget::geometryCache() const
+{
+    if (_geometryCache.isNull()) {
+        _geometryCache.reset(new GeometryCache);
+    }
+
+    return *_geometryCache;
+}
+
 void Tg::Widget::setWidgetOvershoot(const SizeOvershoot overshoot)
 {
     if (_widgetOvershoot != overshoot) {
         _widgetOvershoot = overshoot;
+        propertyChanged(PropertyId::WidgetOvershoot);
         emit widgetOvershootChanged(overshoot);
     }
 }
 
-void Tg::Widget::setupPressTimer(QTimer *timer) const
+Tg::TimerWheel::Handle Tg::Widget::createPressTimer()
+{
+    if (_screen.isNull()) {
+        return TimerWheel::invalidHandle;
+    }
+
+    const TimerWheel::Handle handle = _screen->createWidgetTimer(this, 500);
+    ensureExtraProperties().timers.append(handle);
+    return handle;
+}
+
+void Tg::Widget::restartTimer(const TimerWheel::Handle handle) const
+{
+    if (_screen && handle != TimerWheel::invalidHandle) {
+        _screen->startWidgetTimer(handle);
+    }
+}
+
+bool Tg::Widget::isTimerActive(const TimerWheel::Handle handle) const
+{
+    if (_screen) {
+        return _screen->isWidgetTimerActive(handle);
+    }
+
+    return false;
+}
+
+void Tg::Widget::timerExpired(const TimerWheel::Handle handle)
 {
-    timer->setInterval(500);
-    timer->setSingleShot(true);
+    Q_UNUSED(handle)
+    schedulePartialRedraw();
 }
 
 void Tg::Widget::scheduleFullRedraw() const
 {
     emit needsRedraw(RedrawType::Full, this);
+
+    if (_screen) {
+        _screen->scheduleRedraw(RedrawType::Full, this);
+    }
 }
 
 void Tg::Widget::schedulePartialRedraw() const
 {
-    emit needsRedraw(RedrawType::Partial, this);
+    markDirty(RedrawType::Partial);
+}
+
+void Tg::Widget::scheduleRectangleRedraw(const QRect &rectangle) const
+{
+    if (_isDirty || _screen == nullptr) {
+        return;
+    }
+
+    // Inverse of mapFromGlobal(). mapToGlobal() leaves out borders of
+    // ancestors, which would move the region up and to the left
+    updateGlobalGeometry();
+    const QRect region(rectangle.translated(
+                           _geometryCache->globalMappingOffset));
+    _screen->scheduleRegionRedraw(region.intersected(globalBoundingRectangle()));
 }
 
 void Tg::Widget::schedulePreviousPositionRedraw() const
 {
-    emit needsRedraw(RedrawType::PreviousPosition, this);
+    markDirty(RedrawType::PreviousPosition);
 }
 
 bool Tg::Widget::canRedraw() const
@@ -766,6 +988,106 @@ void Tg::Widget::updatePreviousBoundingRect()
     _previousSize = _size;
 }
 
+void Tg::Widget::markDirty(const RedrawType type) const
+{
+    // Only the area occupied when the widget was last drawn needs cleaning
+    // up, intermediate positions within a frame were never visible
+    if (type == RedrawType::PreviousPosition
+            && _isPreviousPositionDirty == false) {
+        geometryCache().dirtyPreviousRectangle
+                = globalPreviousBoundingRectangle();
+        _isPreviousPositionDirty = true;
+    }
+
+    if (_isDirty) {
+        return;
+    }
+
+    _isDirty = true;
+
+    if (_screen) {
+        _screen->scheduleWidgetRedraw(this);
+    }
+}
+
+void Tg::Widget::updateGlobalGeometry() const
+{
+    if (_isGlobalGeometryValid) {
+        return;
+    }
+
+    // Parent geometry is validated first, so a valid Widget always has valid
+    // parents. That lets invalidateGlobalGeometry() stop early
+    GeometryCache &cache = geometryCache();
+    const Widget *parent = parentWidget();
+    if (parent) {
+        parent->updateGlobalGeometry();
+        const GeometryCache &parentCache = *parent->_geometryCache;
+
+        const int border = parent->effectiveBorderWidth();
+        cache.globalPosition = _position + parentCache.globalPosition;
+        cache.globalMappingOffset = _position + QPoint(border, border)
+                + parentCache.globalMappingOffset;
+        cache.globalBoundingRectangle = QRect(
+            cache.globalPosition + QPoint(border, border), _size);
+
+        const QRect parentContents(
+            parentCache.globalBoundingRectangle.topLeft()
+                + parent->contentsRectangle().topLeft(),
+            parent->contentsRectangle().size());
+        cache.globalClipRectangle = cache.globalBoundingRectangle
+                .intersected(parentContents)
+                .intersected(parentCache.globalClipRectangle);
+    } else {
+        cache.globalPosition = _position;
+        cache.globalMappingOffset = _position;
+        cache.globalBoundingRectangle = QRect(cache.globalPosition, _size);
+        cache.globalClipRectangle = cache.globalBoundingRectangle;
+    }
+
+    _isGlobalGeometryValid = true;
+}
+
+void Tg::Widget::invalidateGlobalGeometry()
+{
+    if (_isGlobalGeometryValid == false) {
+        return;
+    }
+
+    _isGlobalGeometryValid = false;
+
+    for (const auto &child : qAsConst(_childrenWidgets)) {
+        if (child) {
+            child->invalidateGlobalGeometry();
+        }
+    }
+}
+
+void Tg::Widget::addChildWidget(Widget *child)
+{
+    // Insert after all widgets with the same or lower z value, so that the
+    // list stays sorted without re-sorting it
+    auto position = std::upper_bound(
+        _childrenWidgets.begin(), _childrenWidgets.end(), child->z(),
+        [](const int z, const WidgetPointer &widget) {
+            return z < widget->z();
+        });
+    _childrenWidgets.insert(position, WidgetPointer(child));
+}
+
+void Tg::Widget::removeChildWidget(Widget *child)
+{
+    _childrenWidgets.removeAll(child);
+}
+
+void Tg::Widget::sortChildrenWidgets()
+{
+    std::stable_sort(_childrenWidgets.begin(), _childrenWidgets.end(),
+                     [](const WidgetPointer &left, const WidgetPointer &right) {
+        return left->z() < right->z();
+    });
+}
+
 bool Tg::Widget::isModal() const
 {
     return _isModal;
@@ -4,15 +4,18 @@
 #include <QPoint>
 #include <QSize>
 #include <QPointer>
+#include <QScopedPointer>
 
 #include <QMetaEnum>
 
 #include <tgcolor.h>
+#include <tgevent.h>
 
 #include "utils/tghelpers.h"
 #include "layouts/tglayout.h"
-
-class QTimer;
+#include "styles/tgstyle.h"
+#include "utils/tgtimerwheel.h"
+#include "utils/tglinecells.h"
 
 namespace Tg {
 class Screen;
@@ -37,9 +40,10 @@ class Layout;
  * \li one taking Widget pointer - used when subclass is not a top-level widget
  *
  * If a subclass needs keyboard interaction, it should call setAcceptsFocus() in
- * its init() override, and implement consumeKeyboardBuffer() with logic
- * responding to key presses. See Key namespace for helper constants which make
- * detection of particular clicks easier.
+ * its init() override, and implement keyPressEvent() with logic responding to
+ * key presses. Mouse clicks and wheel scrolling are delivered through
+ * mousePressEvent() and wheelEvent(). See Key::Code for the list of decoded
+ * keys.
  *
  * \section diff Differences from Qt Widgets
  *
@@ -174,7 +178,7 @@ class Widget : public QObject
 
     /*!
      * When true, Widget will receive keyboard signals (Screen will call
-     * consumeKeyboardBuffer()) when its turn comes.
+     * keyPressEvent()) when its turn comes.
      */
     Q_PROPERTY(bool acceptsFocus READ acceptsFocus NOTIFY acceptsFocusChanged)
 
@@ -206,6 +210,7 @@ class Widget : public QObject
 
     friend class Screen;
     friend class ScrollArea;
+    friend class FocusChain;
 
 public:
     /*!
@@ -261,6 +266,17 @@ public:
      */
     QRect globalBoundingRectangle() const;
 
+    /*!
+     * Returns the part of globalBoundingRectangle() which is not clipped by
+     * contents rectangles of parent widgets - that is, the area of Screen
+     * where this Widget can actually be seen.
+     *
+     * \note Global geometry is cached, and only recalculated after this Widget
+     * or one of its parents has been moved, resized or had its border
+     * toggled.
+     */
+    QRect globalClipRectangle() const;
+
     /*!
      * Returns the rectangle which holds Widget interior. It is similar to
      * boundingRectangle() but with Widget border removed.
@@ -354,7 +370,7 @@ public:
      * Screen instance - but only when it actively holds focus (see hasFocus()).
      *
      * In order to be able to "do something" with keyboard events, reimplement
-     * consumeKeyboardBuffer().
+     * keyPressEvent().
      *
      * \sa hasFocus, acceptsFocus
      */
@@ -494,8 +510,11 @@ public:
 
 signals:
     /*!
-     * Indicates that \a widget (usually `this`) needs to be redrawn using
+     * Indicates that \a widget (usually `this`) is about to be redrawn using
      * redraw \a type.
+     *
+     * Partial redraws are batched: no matter how many properties changed,
+     * this signal is emitted once per frame, right before Screen draws it.
      */
     void needsRedraw(const RedrawType type, const Widget *widget) const;
 
@@ -593,7 +612,9 @@ signals:
     void widgetOvershootChanged(const SizeOvershoot overshoot) const;
 
     /*!
-     * Emitted when a \a child Widget has been added.
+     * Emitted once, when a \a child Widget has been added. It is emitted
+     * from Widget constructor, so \a child is not fully constructed yet: only
+     * Widget's properties and signals can be used.
      */
     void childAdded(Widget *child) const;
 
@@ -680,9 +701,14 @@ public slots:
     void setZ(const int z);
 
     /*!
-     * Returns all children of this Widget which can be cast to Widget.
+     * Returns all children of this Widget which can be cast to Widget, sorted
+     * by z value (lowest first; widgets with equal z keep the order in which
+     * they were added).
+     *
+     * The list is maintained incrementally when children are added, removed
+     * or change their z value, so calling this method is cheap.
      */
-    WidgetList childrenWidgets() const;
+    const WidgetList &childrenWidgets() const;
 
     /*!
      * Returns a list of all (direct and indirect) children of which Widget
@@ -690,6 +716,9 @@ public slots:
      *
      * \warning Recursive!
      *
+     * \deprecated Tab navigation does not use it anymore, Screen keeps an
+     * ordered focus chain instead. Kept for compatibility.
+     *
      * \sa acceptsFocus
      */
     WidgetList allFocusableChildrenWidgets() const;
@@ -697,14 +726,73 @@ public slots:
 protected:
     /*!
      * Initializes Widget and it's connections. All subclasses should call
-     * init() of its parent class. If a subclass has any properties or signals
-     * which affect the visual look of the Widget, it should reimplement init()
-     * and connect such signal to schedulePartialRedraw() slot.
+     * init() of its parent class. If a subclass has any properties which
+     * affect the visual look of the Widget, their setters should call
+     * propertyChanged().
      *
-     * \sa schedulePartialRedraw
+     * Every constructor calls init() of its own class, so for a single
+     * Widget init() of a base class runs once for each class derived from
+     * it. Work which must happen only once (creating child widgets,
+     * connections, timers) has to check whether it was done already.
+     *
+     * \sa propertyChanged, schedulePartialRedraw
      */
     virtual void init();
 
+    /*!
+     * Identifies a property which affects how the Widget looks. Passed to
+     * propertyChanged().
+     *
+     * Each subclass numbers its own properties after the ones of its base
+     * class, in a struct deriving from PropertyId of the base class. This
+     * way properties of all base classes are reachable through it, and
+     * widgets defined outside of this library can add their own:
+     *
+     * \code
+     * struct PropertyId : Tg::Label::PropertyId {
+     *     enum : int {
+     *         Value = Tg::Label::PropertyId::Last,
+     *         Last
+     *     };
+     * };
+     * \endcode
+     *
+     * Numbers used by unrelated classes overlap, which is fine: a Widget
+     * only ever receives properties of its own class hierarchy.
+     */
+    struct PropertyId {
+        enum : int {
+            Position,
+            Size,
+            BackgroundColor,
+            BackgroundCharacter,
+            TextColor,
+            BorderTextColor,
+            Visible,
+            BorderVisible,
+            HasFocus,
+            Style,
+            LayoutOvershoot,
+            WidgetOvershoot,
+            //! First number free for properties of a subclass
+            Last
+        };
+    };
+
+    /*!
+     * Called when \a property of this Widget has changed, right before its
+     * NOTIFY signal is emitted. Default implementation schedules a redraw of
+     * the Widget (for Position and Size - also of the area it used to
+     * occupy).
+     *
+     * Subclasses react to changes of their own properties by reimplementing
+     * this method instead of connecting to their own signals, which keeps
+     * construction of widgets cheap. Reimplementations should call the
+     * implementation of parent class. Properties introduced by a subclass
+     * are reported by calling propertyChanged() from their setters.
+     */
+    virtual void propertyChanged(const int property);
+
     /*!
      * Sets this Widget to hold \a active focus (or not). This method is
      * typically only called by Screen. Setting it manually may lead to side
@@ -713,10 +801,53 @@ protected:
     void setHasFocus(const bool active);
 
     /*!
-     * Called when Widget accepts focus and \a keyboardBuffer is not empty.
+     * Called when Widget holds active focus and a key has been pressed, or
+     * when one of Widget's children did not handle the key \a event.
+     *
+     * Return `true` if \a event has been handled. Otherwise, it will be passed
+     * to parentWidget().
+     *
+     * Default implementation passes the raw key sequence to
+     * consumeKeyboardBuffer().
+     *
+     * \sa acceptsFocus, hasFocus
+     */
+    virtual bool keyPressEvent(const KeyEvent &event);
+
+    /*!
+     * Called when a mouse button has been pressed over this Widget. Only
+     * Widgets which accept focus receive mouse press events.
+     *
+     * Return `true` if \a event has been handled.
      *
      * \sa acceptsFocus
      */
+    virtual bool mousePressEvent(const MouseEvent &event);
+
+    /*!
+     * Called when mouse wheel has been scrolled over this Widget. If \a event
+     * is not handled (`false` is returned), it will be passed to
+     * parentWidget().
+     */
+    virtual bool wheelEvent(const WheelEvent &event);
+
+    /*!
+     * Called when Widget has focus and the user pasted some text into the
+     * terminal. The whole paste is delivered at once. If \a event is not
+     * handled (`false` is returned), it will be passed to parentWidget().
+     *
+     * \sa Terminal::enableBracketedPaste
+     */
+    virtual bool pasteEvent(const PasteEvent &event);
+
+    /*!
+     * Called when Widget accepts focus and \a keyboardBuffer is not empty.
+     *
+     * \deprecated This is a compatibility shim, it receives raw sequence of a
+     * single key press. Reimplement keyPressEvent() instead.
+     *
+     * \sa acceptsFocus, keyPressEvent
+     */
     virtual bool consumeKeyboardBuffer(const QString &keyboardBuffer);
 
     /*!
@@ -779,10 +910,9 @@ protected:
     /*!
      * If \a enable is `true`, clicking up arrow or down arrow on keyboard will
      * be intercepted by parent Screen and used to switch focus to previous or
-     * next Widget. This Widget will not receive a call to
-     * consumeKeyboardBuffer().
+     * next Widget. This Widget will not receive a call to keyPressEvent().
      *
-     * \sa consumeKeyboardBuffer, hasFocus, acceptsFocus
+     * \sa keyPressEvent, hasFocus, acceptsFocus
      */
     void setVerticalArrowsMoveFocus(const bool enable);
 
@@ -813,28 +943,100 @@ protected:
      */
     StylePointer style() const;
 
+    /*!
+     * Returns style() with all local overrides of this Widget (like
+     * backgroundColor, or ScrollBar::sliderColor) already applied.
+     *
+     * This snapshot is recomputed whenever Style or one of the overrides
+     * changes, so drawing code can read its fields directly instead of
+     * checking each override and falling back to style() for every
+     * character. Widgets without any overrides (see hasStyleOverrides())
+     * do not keep a snapshot and return style() itself.
+     *
+     * \sa updateResolvedStyle, Screen::refreshStyle
+     */
+    const Style &resolvedStyle() const;
+
+    /*!
+     * Recomputes resolvedStyle(). Subclasses must call it after changing any
+     * of their style overrides.
+     *
+     * \sa applyStyleOverrides
+     */
+    void updateResolvedStyle();
+
+    /*!
+     * Writes local style overrides of this Widget into \a resolved, which
+     * initially holds a copy of style().
+     *
+     * Subclasses which define their own style overrides should reimplement
+     * this method, and call the implementation of their parent class first.
+     */
+    virtual void applyStyleOverrides(Style *resolved) const;
+
+    /*!
+     * Returns `true` if any style override of this Widget is set. Subclasses
+     * which reimplement applyStyleOverrides() must reimplement this method,
+     * too.
+     */
+    virtual bool hasStyleOverrides() const;
+
     /*!
      * Sets current \a overshoot of the contents of this Widget.
      */
     void setWidgetOvershoot(const SizeOvershoot overshoot);
 
     /*!
-     * Sets \a timer object which controls how long pressed elements (buttons,
-     * scroll bar arrows, etc.) look different (pressed).
+     * Creates a timer which controls how long pressed elements (buttons,
+     * scroll bar arrows, etc.) look different (pressed). Start it with
+     * restartTimer(), and check with isTimerActive() when drawing.
      *
-     * \warning This method does not take ownership of the \a timer
+     * Timer is owned by the TimerWheel of Screen, and is destroyed together
+     * with this Widget.
      *
-     * \sa Button, ScrollBar
+     * \sa Button, ScrollBar, timerExpired
      */
-    void setupPressTimer(QTimer *timer) const;
+    TimerWheel::Handle createPressTimer();
 
     /*!
-     * Forces Widget to lay out its children according to layoutType().
+     * Starts timer \a handle (created with createPressTimer()), or restarts
+     * it if it is already running.
+     */
+    void restartTimer(const TimerWheel::Handle handle) const;
+
+    /*!
+     * Returns `true` if timer \a handle is running.
+     */
+    bool isTimerActive(const TimerWheel::Handle handle) const;
+
+    /*!
+     * Called by Screen when timer \a handle of this Widget expires. Default
+     * implementation schedules a partial redraw, which is enough for press
+     * timers checked with isTimerActive() when drawing.
+     */
+    virtual void timerExpired(const TimerWheel::Handle handle);
+
+    /*!
+     * Forces Widget to lay out its children according to layoutType(),
+     * immediately.
      *
-     * \sa layoutType
+     * Usually there is no need to call this method: changes to size,
+     * visibility or children of the Widget call scheduleLayout(), and Screen
+     * lays out all such widgets once, right before the next frame is drawn.
+     *
+     * \sa layoutType, scheduleLayout
      */
     void doLayout();
 
+    /*!
+     * Marks layout of this Widget as dirty. Screen will call doLayout() right
+     * before drawing next frame, parents before their children. Calling this
+     * method many times within a single frame is cheap.
+     *
+     * \sa doLayout
+     */
+    void scheduleLayout();
+
 protected slots:
     /*!
      * Instructs Screen that full redraw of entire Screen area should be
@@ -847,10 +1049,24 @@ protected slots:
     /*!
      * Instructs Screen to redraw this Widget only, at its current position.
      *
+     * This only marks the Widget as dirty; it is added to Screen's damage
+     * list once, no matter how many times it is called before next frame.
+     *
      * \sa position, size
      */
     void schedulePartialRedraw() const;
 
+    /*!
+     * Instructs Screen to redraw only \a rectangle (in this Widget's
+     * coordinates) of this Widget. Use it when a small part of a large Widget
+     * changes, for example when a line is appended to LogView.
+     *
+     * Does nothing if the whole Widget is already scheduled for a redraw.
+     *
+     * \sa schedulePartialRedraw
+     */
+    void scheduleRectangleRedraw(const QRect &rectangle) const;
+
     /*!
      * Instructs Screen to redraw the area previously occupied by this Widget.
      * This is necessary to "clean up" the are of Screen where Widget used to be
@@ -861,16 +1077,53 @@ protected slots:
     void schedulePreviousPositionRedraw() const;
 
 private:
+    struct ExtraProperties {
+        Tg::Color textColor;
+        Tg::Color borderTextColor;
+        Tg::Color borderBackgroundColor;
+        QByteArray backgroundCharacter;
+        QString title;
+        LineCells titleCells;
+        // Press timers, see createPressTimer()
+        QVector<TimerWheel::Handle> timers;
+        // Only allocated when hasStyleOverrides(), see resolvedStyle()
+        QScopedPointer<Style> resolvedStyle;
+    };
+
+    struct GeometryCache {
+        // Global geometry, see updateGlobalGeometry()
+        QPoint globalPosition;
+        QPoint globalMappingOffset;
+        QRect globalBoundingRectangle;
+        QRect globalClipRectangle;
+        // Area to clean up on next frame, see markDirty()
+        QRect dirtyPreviousRectangle;
+    };
+
+    const ExtraProperties &extraProperties() const;
+    ExtraProperties &ensureExtraProperties();
+    GeometryCache &geometryCache() const;
+
     bool canRedraw() const;
     void updatePreviousBoundingRect();
 
+    void updateGlobalGeometry() const;
+    void invalidateGlobalGeometry();
+
+    void markDirty(const RedrawType type) const;
+
+    void addChildWidget(Widget *child);
+    void removeChildWidget(Widget *child);
+    void sortChildrenWidgets();
+
     const int _borderWidth = 1;
     bool _resizableByMouse = true;
 
     QPointer<Screen> _screen;
     QPointer<Widget> _parentWidget;
+    WidgetList _childrenWidgets;
     StylePointer _style;
-    // TODO: smart pointer
+    // nullptr for Layout::Type::None, see doLayout()
     Layout *_layout = nullptr;
     SizeOvershoot _layoutOvershoot = Overshoot::None;
     SizeOvershoot _widgetOvershoot = Overshoot::None;
@@ -881,10 +1134,25 @@ private:
     QSize _previousSize = { 1, 1 };
     int _z = 0;
 
+    // Positions in Screen's widget lists, see Screen::registerWidget()
+    int _screenIndex = -1;
+    int _topLevelScreenIndex = -1;
+
     Tg::Color _backgroundColor;
-    Tg::Color _textColor;
-    Tg::Color _borderTextColor;
-    Tg::Color _borderBackgroundColor;
+
+    // Tab order, assigned on registration. See FocusChain
+    quint64 _focusOrder = 0;
+
+    // Allocated on first use, see geometryCache()
+    mutable QScopedPointer<GeometryCache> _geometryCache;
+    mutable bool _isGlobalGeometryValid = false;
+
+    // Set by scheduleLayout(), cleared by doLayout()
+    bool _isLayoutDirty = false;
+
+    // Pending redraw, see markDirty()
+    mutable bool _isDirty = false;
+    mutable bool _isPreviousPositionDirty = false;
 
     bool _visible = false;
     bool _borderVisible = true;
@@ -892,8 +1160,9 @@ private:
     bool _hasFocus = false;
     bool _verticalArrowsMoveFocus = false;
     bool _propagatesStyle = true;
-    QByteArray _backgroundCharacter;
-    QString _title;
     bool _isModal;
+
+    // Rarely set properties, allocated on first write
+    QScopedPointer<ExtraProperties> _extraProperties;
 };
 }